@@ -9,21 +9,61 @@
 #include <notification/notification_messages.h>
 #include <furi_hal_rtc.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include <gui/gui.h>
 #include <gui/view_port.h>
 #include <gui/canvas.h>
 
+#include "bleash_calibration.h"
+#include "bleash_observer.h"
+#include "bleash_view.h"
+
 #define TAG                        "Bleash"
 #define LOG_FOLDER_PATH            "/ext/Bleash"
 #define LOG_FILE_PATH              "/ext/Bleash/bleash.log"
+#define LOG_SNAPSHOT_FILE_PATH     "/ext/Bleash/bleash.log.export"
 #define STATE_FILE_PATH            "/ext/Bleash/bleash.state"
 #define INSTANCE_FILE_PATH         "/ext/Bleash/bleash.instance"
-#define RSSI_THRESHOLD             -70
-#define POLL_INTERVAL_MS           1000
+#define EXPORT_FOLDER_PATH         "/ext/Bleash/export"
+#define WATCHLIST_FILE_PATH        "/ext/Bleash/watchlist.txt"
+#define ADV_REPLAY_FILE_PATH       "/ext/Bleash/adv_replay.bin"
+#define ROLLUP_FILE_PATH           "/ext/Bleash/rollup.bin"
+#define RSSI_THRESHOLD             -70 // Default until calibrated
 #define DEFAULT_BACKGROUND_RUNNING false
+#define DEFAULT_POWER_PROFILE      BleashPowerProfileBalanced
 #define BLE_APP_NAME               "BLE Leash"
 #define BACKGROUND_WORKER_STACK    2048
-#define VIEW_UPDATE_INTERVAL       500
+#define EXPORT_CHUNK_SIZE          4096
+#define EXPORT_THREAD_STACK        2048
+#define EXPORT_LINE_MAX            128
+#define LOG_LINE_MAX               160
+#define LOG_BATCH_SIZE             512 // Exit records, written with one append
+#define OBSERVER_LOST_TIMEOUT_MS   10000
+#define BT_UNHOOK_GRACE_MS         150 // Upper bound for a BT dispatch already under way
+#define ADV_REPLAY_BATCH           32
+#define SCHED_MAX_CATCH_UP         3 // Back-to-back samples before a catch-up gives up
+
+// Energy model used for the per-hour estimate, charge in uC (mA * ms)
+#define ENERGY_CPU_ACTIVE_MA   7 // MCU running at full clock
+#define ENERGY_WAKEUP_UC       20 // Leaving and re-entering sleep
+#define ENERGY_STORAGE_OP_UC   300 // SD card open/write/close
+#define ENERGY_REDRAW_UC       150 // Canvas render and display transfer
+#define ENERGY_VIBRO_MA        90 // Vibration motor
+
+// Threshold calibration: percentile of the carried-normally distribution minus a margin
+#define CALIBRATION_WINDOW_MS   120000
+#define CALIBRATION_PERCENTILE  5
+#define CALIBRATION_MARGIN_DB   5
+#define CALIBRATION_MIN_SAMPLES 30
+#define CALIBRATION_MIN_DBM     -100
+#define CALIBRATION_MAX_DBM     -40
+
+// Worker thread flags
+#define BLEASH_WORKER_FLAG_EXIT      (1UL << 0)
+#define BLEASH_WORKER_FLAG_BT_STATUS (1UL << 1)
+
+#define BT_MAILBOX_SIZE 16 // Power of two
 
 // Custom notification sequences
 const NotificationSequence sequence_set_vibro_on = {
@@ -63,6 +103,196 @@ typedef struct {
     InputEvent input;
 } BleashEvent;
 
+typedef enum {
+    BleashExportFormatCsv,
+    BleashExportFormatJsonLines,
+} BleashExportFormat;
+
+// Alert the worker raised on a sample, logged as ALERT= and carried into exports
+typedef enum {
+    BleashAlertNone = 0,
+    BleashAlertWeakSignal = 1,
+    BleashAlertDisconnect = 2,
+} BleashAlert;
+
+// Export status codes past the BtStatus range, for observer samples
+#define EXPORT_STATUS_OBSERVER_ALL     4 // Every watched target present
+#define EXPORT_STATUS_OBSERVER_MISSING 5 // A watched target missing, or none watched
+
+typedef struct {
+    uint32_t timestamp;
+    BtStatus status; // Connection samples only
+    bool observer;
+    uint8_t present; // Observer samples only
+    uint8_t targets;
+    int8_t rssi;
+    bool has_alert; // False for lines written before ALERT= was logged
+    BleashAlert alert;
+    uint16_t period_s; // 0 for lines written before PERIOD= was logged
+} BleashLogSample;
+
+typedef enum {
+    BleashLeashModeConnection, // Leash on the BLE connection to a bonded device
+    BleashLeashModeObserver, // Leash on advertisements from watched tags
+    BleashLeashModeCount,
+} BleashLeashMode;
+
+// Stand-in advertisement source. The firmware exposes no GAP observer API to apps,
+// so reports are replayed from a capture at their recorded pace, looping at EOF.
+typedef struct {
+    File* file;
+    BleashAdvReport batch[ADV_REPLAY_BATCH];
+    size_t batch_count;
+    size_t batch_pos;
+    uint32_t start_ms; // Device time matching capture time 0 of the current loop
+    uint32_t last_time_ms;
+} BleashAdvSource;
+
+typedef enum {
+    BleashPowerProfilePerformance,
+    BleashPowerProfileBalanced,
+    BleashPowerProfileSaver,
+    BleashPowerProfileCount,
+} BleashPowerProfileId;
+
+// What the worker does when a pass ends past the next sample deadline
+typedef enum {
+    BleashOverrunCatchUp, // Take missed samples back-to-back (bounded), then resync
+    BleashOverrunSkip, // Drop missed samples and stay on the original grid
+} BleashOverrunPolicy;
+
+// Everything that trades battery for responsiveness, switched as one unit
+typedef struct {
+    const char* name;
+    uint32_t sample_interval_ms;
+    uint8_t log_every_samples; // Status changes and alerts are always logged
+    uint32_t redraw_interval_ms;
+    uint32_t weak_vibro_ms;
+    uint32_t disconnect_vibro_ms;
+    uint8_t disconnect_pulses;
+    bool alert_led;
+    BleashOverrunPolicy overrun_policy;
+} BleashPowerProfile;
+
+static const BleashPowerProfile bleash_power_profiles[BleashPowerProfileCount] = {
+    [BleashPowerProfilePerformance] =
+        {
+            .name = "Perf",
+            .sample_interval_ms = 500,
+            .log_every_samples = 1,
+            .redraw_interval_ms = 250,
+            .weak_vibro_ms = 200,
+            .disconnect_vibro_ms = 150,
+            .disconnect_pulses = 2,
+            .alert_led = true,
+            .overrun_policy = BleashOverrunCatchUp,
+        },
+    [BleashPowerProfileBalanced] =
+        {
+            .name = "Bal",
+            .sample_interval_ms = 1000,
+            .log_every_samples = 5,
+            .redraw_interval_ms = 500,
+            .weak_vibro_ms = 150,
+            .disconnect_vibro_ms = 150,
+            .disconnect_pulses = 2,
+            .alert_led = true,
+            .overrun_policy = BleashOverrunCatchUp,
+        },
+    [BleashPowerProfileSaver] =
+        {
+            .name = "Saver",
+            .sample_interval_ms = 3000,
+            .log_every_samples = 10,
+            .redraw_interval_ms = 1000,
+            .weak_vibro_ms = 80,
+            .disconnect_vibro_ms = 120,
+            .disconnect_pulses = 1,
+            .alert_led = false,
+            .overrun_policy = BleashOverrunSkip,
+        },
+};
+
+// Duty-cycle accounting since the profile was last selected. Counters are bumped
+// from the worker, the timer and the GUI, hence atomics.
+typedef struct {
+    uint32_t since_tick;
+    atomic_uint worker_active_ticks;
+    atomic_uint wakeups;
+    atomic_uint storage_ops;
+    atomic_uint redraws;
+    atomic_uint vibro_ms;
+} BleashEnergyStats;
+
+typedef enum {
+    BleashRollupKindHour = 0,
+    BleashRollupKindDay = 1,
+} BleashRollupKind;
+
+#define ROLLUP_STATUS_COUNT (BtStatusConnected + 1)
+
+// On-disk rollup record (little endian, 40 bytes). Records are additive: a period
+// split by an app restart is written twice with the same start and readers sum them.
+typedef struct {
+    uint32_t start; // RTC epoch of the hour/day start
+    uint32_t status_seconds[4]; // Indexed by BtStatus
+    uint32_t below_threshold_seconds;
+    uint32_t rssi_samples; // Connected samples
+    int32_t rssi_sum;
+    uint16_t disconnects;
+    uint8_t kind;
+    uint8_t reserved;
+    int8_t rssi_min;
+    int8_t rssi_max;
+    uint8_t padding[2];
+} BleashRollupRecord;
+
+_Static_assert(sizeof(BleashRollupRecord) == 40, "Rollup record layout is part of the file format");
+_Static_assert(ROLLUP_STATUS_COUNT == 4, "Rollup record holds one counter per BtStatus");
+
+// Running aggregate for the open hour or day, kept in ms until it is written
+typedef struct {
+    bool active;
+    uint32_t start;
+    uint32_t status_ms[ROLLUP_STATUS_COUNT];
+    uint32_t below_threshold_ms;
+    uint32_t rssi_samples;
+    int32_t rssi_sum;
+    uint16_t disconnects;
+    int8_t rssi_min;
+    int8_t rssi_max;
+} BleashRollup;
+
+// Sampling schedule quality since the profile was last selected. Written by the
+// worker and read or reset by the main loop, both under the mutex.
+// Jitter is how late a sample started relative to its absolute deadline.
+typedef struct {
+    uint32_t samples;
+    uint32_t jitter_sum_ticks;
+    uint32_t jitter_max_ticks;
+    uint32_t overruns; // Passes that ended past the next deadline
+    uint32_t caught_up; // Missed samples taken late
+    uint32_t skipped; // Missed samples dropped
+} BleashSchedStats;
+
+// BT status transitions from the BT service thread to the worker. Single producer,
+// single consumer: the callback only writes head, the worker only writes tail, so
+// publishing never waits. If the worker ever falls a whole ring behind, the newest
+// status is still in latest and the gap is counted.
+typedef struct {
+    uint8_t ring[BT_MAILBOX_SIZE]; // BtStatus
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_uint latest;
+    atomic_uint overflows;
+} BleashBtMailbox;
+
+typedef struct {
+    bool active;
+    uint32_t start_tick;
+    BleashRssiHistogram histogram;
+} BleashCalibration;
+
 typedef struct {
     FuriMessageQueue* event_queue;
     ViewPort* view_port;
@@ -73,56 +303,421 @@ typedef struct {
     bool background_running;
     int8_t last_rssi;
     bool was_connected;
-    bool running;
-    bool should_exit;
+    atomic_bool running;
+    atomic_bool should_exit;
     FuriThread* thread;
+    _Atomic(FuriThreadId) worker_id; // Set by the worker itself once it runs
     FuriMutex* mutex;
-    volatile bool processing;
+    atomic_bool processing;
+    atomic_uint callbacks_active; // Callbacks currently executing, drained on teardown
+    uint32_t exit_request_tick;
+    char* log_batch; // Main loop, while set log_printf collects lines here
+    size_t log_batch_len;
     FuriTimer* update_timer;
     bool is_active;
-    BtStatus bt_status;
+    BtStatus bt_status; // Worker owned, fed from bt_mailbox
+    BleashBtMailbox bt_mailbox;
+    bool bt_link_lost; // Worker only: a drained transition left Connected since the last pass
+    BleashPowerProfileId power_profile;
+    uint8_t samples_since_log;
+    BtStatus last_logged_status;
+    int8_t rssi_threshold;
+    BleashCalibration calibration;
+    BleashEnergyStats energy;
+    uint32_t worker_wait_ticks; // Worker only: ticks slept inside the current pass
+    BleashSchedStats sched;
+    uint32_t last_jitter_ticks;
+    BleashRollup rollup_hour;
+    BleashRollup rollup_day;
+    uint32_t rollup_last_tick;
+    BleashLeashMode leash_mode;
+    bool observer_ready;
+    uint16_t observer_present; // Bit per watched target seen within the timeout, 16 max
+    uint8_t logged_present_count;
+    BleashObserver observer;
+    BleashAdvSource adv_source;
+    FuriThread* export_thread;
+    atomic_bool exporting;
+    BleashExportFormat export_format;
+    BleashViewCache view_cache; // GUI thread only
+    BleashViewModel view_model_drawn; // Main loop only: model of the last requested frame
 } Bleash;
 
-static void log_event(Bleash* b, int8_t rssi) {
-    DateTime dt;
-    furi_hal_rtc_get_datetime(&dt);
-    char line[128];
+static const BleashPowerProfile* bleash_profile(Bleash* bleash) {
+    return &bleash_power_profiles[bleash->power_profile];
+}
 
-    const char* status_str = "Unknown";
-    switch(b->bt_status) {
-    case BtStatusOff:
-        status_str = "Off";
-        break;
-    case BtStatusAdvertising:
-        status_str = "Advertising";
-        break;
-    case BtStatusConnected:
-        status_str = "Connected";
-        break;
-    case BtStatusUnavailable:
-        status_str = "Unavailable";
-        break;
+static void bleash_sched_reset(Bleash* bleash) {
+    memset(&bleash->sched, 0, sizeof(BleashSchedStats));
+}
+
+static void bleash_energy_reset(Bleash* bleash) {
+    bleash->energy.since_tick = furi_get_tick();
+    atomic_store(&bleash->energy.worker_active_ticks, 0);
+    atomic_store(&bleash->energy.wakeups, 0);
+    atomic_store(&bleash->energy.storage_ops, 0);
+    atomic_store(&bleash->energy.redraws, 0);
+    atomic_store(&bleash->energy.vibro_ms, 0);
+}
+
+// The accounting window spans the whole day, ticks * 1000 wraps 32 bits after 71 minutes
+static uint32_t bleash_energy_ticks_to_ms(uint32_t ticks) {
+    return (uint64_t)ticks * 1000 / furi_kernel_get_tick_frequency();
+}
+
+// Average app-attributable current over the accounting window, which is also the
+// battery cost in uAh per hour
+static uint32_t bleash_energy_estimate_ua(Bleash* bleash, uint32_t* wakeups_per_minute) {
+    uint32_t window_ms = bleash_energy_ticks_to_ms(furi_get_tick() - bleash->energy.since_tick);
+    if(window_ms < 1000) window_ms = 1000;
+
+    uint32_t active_ms =
+        bleash_energy_ticks_to_ms(atomic_load(&bleash->energy.worker_active_ticks));
+    uint32_t wakeups = atomic_load(&bleash->energy.wakeups);
+    uint64_t charge_uc = (uint64_t)active_ms * ENERGY_CPU_ACTIVE_MA +
+                         (uint64_t)wakeups * ENERGY_WAKEUP_UC +
+                         (uint64_t)atomic_load(&bleash->energy.storage_ops) * ENERGY_STORAGE_OP_UC +
+                         (uint64_t)atomic_load(&bleash->energy.redraws) * ENERGY_REDRAW_UC +
+                         (uint64_t)atomic_load(&bleash->energy.vibro_ms) * ENERGY_VIBRO_MA;
+
+    if(wakeups_per_minute) {
+        *wakeups_per_minute = (uint64_t)wakeups * 60000 / window_ms;
+    }
+    return charge_uc * 1000 / window_ms;
+}
+
+// Callback guards: every callback registered with a system service brackets its
+// work with enter/leave so teardown can wait for in-flight calls instead of sleeping
+static void bleash_callback_leave(Bleash* bleash) {
+    atomic_fetch_sub(&bleash->callbacks_active, 1);
+}
+
+static bool bleash_callback_enter(Bleash* bleash, bool gui) {
+    atomic_fetch_add(&bleash->callbacks_active, 1);
+    if(atomic_load(&bleash->should_exit) || (gui && atomic_load(&bleash->processing))) {
+        bleash_callback_leave(bleash);
+        return false;
+    }
+    return true;
+}
+
+static void bleash_drain_callbacks(Bleash* bleash) {
+    while(atomic_load(&bleash->callbacks_active) > 0) {
+        furi_delay_tick(1);
+    }
+}
+
+// Sleep on the worker thread, waking early on exit request. Returns false on exit.
+static bool bleash_worker_wait_ticks(Bleash* bleash, uint32_t timeout_ticks) {
+    if(atomic_load(&bleash->should_exit)) return false;
+    uint32_t start = furi_get_tick();
+    uint32_t flags = furi_thread_flags_wait(
+        BLEASH_WORKER_FLAG_EXIT, FuriFlagWaitAny | FuriFlagNoClear, timeout_ticks);
+    bleash->worker_wait_ticks += furi_get_tick() - start;
+    atomic_fetch_add(&bleash->energy.wakeups, 1);
+    if(!(flags & FuriFlagError) && (flags & BLEASH_WORKER_FLAG_EXIT)) return false;
+    return !atomic_load(&bleash->should_exit);
+}
+
+static bool bleash_worker_wait(Bleash* bleash, uint32_t timeout_ms) {
+    return bleash_worker_wait_ticks(bleash, furi_ms_to_ticks(timeout_ms));
+}
+
+// Vibrate for duration_ms on the worker thread, stopping early on exit request
+static bool bleash_vibrate(Bleash* bleash, uint32_t duration_ms) {
+    uint32_t start = furi_get_tick();
+    notification_message(bleash->notifications, &sequence_set_vibro_on);
+    bool keep_going = bleash_worker_wait(bleash, duration_ms);
+    notification_message(bleash->notifications, &sequence_reset_vibro);
+    atomic_fetch_add(
+        &bleash->energy.vibro_ms,
+        (furi_get_tick() - start) * 1000 / furi_kernel_get_tick_frequency());
+    return keep_going;
+}
+
+static void bleash_alert_weak_signal(Bleash* bleash) {
+    const BleashPowerProfile* profile = bleash_profile(bleash);
+    if(bleash->notifications && !atomic_load(&bleash->should_exit)) {
+        if(bleash_vibrate(bleash, profile->weak_vibro_ms) && profile->alert_led) {
+            notification_message(bleash->notifications, &sequence_blink_red_10);
+        }
+    }
+}
+
+static void bleash_alert_disconnect(Bleash* bleash) {
+    const BleashPowerProfile* profile = bleash_profile(bleash);
+    if(bleash->notifications && !atomic_load(&bleash->should_exit)) {
+        // Pulsed vibration for disconnection, 100 ms apart
+        for(uint8_t pulse = 0; pulse < profile->disconnect_pulses; pulse++) {
+            if(pulse > 0 && !bleash_worker_wait(bleash, 100)) break;
+            if(!bleash_vibrate(bleash, profile->disconnect_vibro_ms)) break;
+        }
+    }
+}
+
+// Log every Nth sample per profile, but never skip a state change or an alert
+static bool bleash_log_due(Bleash* bleash, bool changed) {
+    bleash->samples_since_log++;
+    if(changed || bleash->samples_since_log >= bleash_profile(bleash)->log_every_samples) {
+        bleash->samples_since_log = 0;
+        return true;
+    }
+    return false;
+}
+
+static void bleash_worker_signal_exit(Bleash* bleash) {
+    atomic_store(&bleash->should_exit, true);
+    if(bleash->thread) {
+        furi_thread_flags_set(furi_thread_get_id(bleash->thread), BLEASH_WORKER_FLAG_EXIT);
+    }
+}
+
+// BT service thread: wait-free, never takes the app mutex
+static void bleash_bt_mailbox_publish(Bleash* bleash, BtStatus status) {
+    BleashBtMailbox* mailbox = &bleash->bt_mailbox;
+    atomic_store_explicit(&mailbox->latest, status, memory_order_relaxed);
+
+    uint32_t head = atomic_load_explicit(&mailbox->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&mailbox->tail, memory_order_acquire);
+    if(head - tail >= BT_MAILBOX_SIZE) {
+        atomic_fetch_add_explicit(&mailbox->overflows, 1, memory_order_relaxed);
+    } else {
+        mailbox->ring[head & (BT_MAILBOX_SIZE - 1)] = status;
+        atomic_store_explicit(&mailbox->head, head + 1, memory_order_release);
+    }
+
+    FuriThreadId worker_id = atomic_load(&bleash->worker_id);
+    if(worker_id) {
+        furi_thread_flags_set(worker_id, BLEASH_WORKER_FLAG_BT_STATUS);
+    }
+}
+
+// Worker, with the mutex held: applies queued transitions in order. A disconnect
+// that is followed by a reconnect before the next sample is latched in bt_link_lost.
+static void bleash_bt_mailbox_drain(Bleash* bleash) {
+    BleashBtMailbox* mailbox = &bleash->bt_mailbox;
+    bool was_connected = bleash->bt_status == BtStatusConnected;
+
+    uint32_t tail = atomic_load_explicit(&mailbox->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&mailbox->head, memory_order_acquire);
+    for(; tail != head; tail++) {
+        BtStatus status = mailbox->ring[tail & (BT_MAILBOX_SIZE - 1)];
+        if(bleash->bt_status == BtStatusConnected && status != BtStatusConnected) {
+            bleash->bt_link_lost = true;
+        }
+        if(status != bleash->bt_status) {
+            FURI_LOG_I(TAG, "BT status changed to %d", status);
+        }
+        bleash->bt_status = status;
+        was_connected |= status == BtStatusConnected;
     }
+    atomic_store_explicit(&mailbox->tail, tail, memory_order_release);
+
+    // Transitions past a full ring are unknown, assume the link dropped if it was up
+    uint32_t overflows = atomic_exchange_explicit(&mailbox->overflows, 0, memory_order_relaxed);
+    if(overflows) {
+        FURI_LOG_W(TAG, "BT mailbox full, %lu transitions coalesced", overflows);
+        bleash->bt_status = atomic_load_explicit(&mailbox->latest, memory_order_relaxed);
+        if(was_connected) bleash->bt_link_lost = true;
+    }
+}
+
+// Sleep between passes until deadline, applying BT status changes as they arrive.
+// Returns false on exit.
+static bool bleash_worker_sleep_until(Bleash* bleash, uint32_t deadline) {
+    while(!atomic_load(&bleash->should_exit)) {
+        int32_t remaining = (int32_t)(deadline - furi_get_tick());
+        uint32_t flags = furi_thread_flags_wait(
+            BLEASH_WORKER_FLAG_EXIT | BLEASH_WORKER_FLAG_BT_STATUS,
+            FuriFlagWaitAny | FuriFlagNoClear,
+            remaining > 0 ? (uint32_t)remaining : 0);
+        atomic_fetch_add(&bleash->energy.wakeups, 1);
+        if(flags & FuriFlagError) return !atomic_load(&bleash->should_exit);
+        if(flags & BLEASH_WORKER_FLAG_EXIT) return false;
+
+        // Clear before draining, a publish racing with the drain sets it again
+        furi_thread_flags_clear(BLEASH_WORKER_FLAG_BT_STATUS);
+        furi_mutex_acquire(bleash->mutex, FuriWaitForever);
+        bleash_bt_mailbox_drain(bleash);
+        furi_mutex_release(bleash->mutex);
+    }
+    return false;
+}
+
+// Seconds since 1970-01-01 for an RTC date (days-from-civil), avoids depending on
+// firmware datetime helpers that moved between releases
+static uint32_t bleash_datetime_to_epoch(const DateTime* dt) {
+    int32_t year = dt->year - (dt->month <= 2 ? 1 : 0);
+    int32_t era = year / 400;
+    uint32_t year_of_era = year - era * 400;
+    uint32_t day_of_year = (153 * (dt->month > 2 ? dt->month - 3 : dt->month + 9) + 2) / 5 +
+                           dt->day - 1;
+    uint32_t day_of_era =
+        year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    int32_t days = era * 146097 + (int32_t)day_of_era - 719468;
+    return (uint32_t)days * 86400 + dt->hour * 3600 + dt->minute * 60 + dt->second;
+}
+
+static void log_append(Bleash* b, const char* line, size_t len) {
+    atomic_fetch_add(&b->energy.storage_ops, 1);
+    File* f = storage_file_alloc(b->storage);
+    if(f && storage_file_open(f, LOG_FILE_PATH, FSAM_WRITE, FSOM_OPEN_ALWAYS | FSOM_OPEN_APPEND)) {
+        storage_file_write(f, (uint8_t*)line, len);
+        storage_file_close(f);
+    }
+    if(f) storage_file_free(f);
+}
 
-    size_t len = snprintf(
+static void log_batch_flush(Bleash* b) {
+    if(b->log_batch_len) log_append(b, b->log_batch, b->log_batch_len);
+    b->log_batch_len = 0;
+}
+
+// Appends one line, prefixed with the RTC timestamp, to bleash.log or the open batch
+static void log_printf(Bleash* b, const char* fmt, ...) {
+    DateTime dt;
+    furi_hal_rtc_get_datetime(&dt);
+    char line[LOG_LINE_MAX];
+
+    int len = snprintf(
         line,
         sizeof(line),
-        "%04d-%02d-%02d %02d:%02d:%02d: BT=%s RSSI=%d\n",
+        "%04d-%02d-%02d %02d:%02d:%02d: ",
         dt.year,
         dt.month,
         dt.day,
         dt.hour,
         dt.minute,
-        dt.second,
-        status_str,
-        rssi);
+        dt.second);
 
-    File* f = storage_file_alloc(b->storage);
-    if(f && storage_file_open(f, LOG_FILE_PATH, FSAM_WRITE, FSOM_OPEN_ALWAYS | FSOM_OPEN_APPEND)) {
-        storage_file_write(f, (uint8_t*)line, len);
-        storage_file_close(f);
+    va_list args;
+    va_start(args, fmt);
+    len += vsnprintf(line + len, sizeof(line) - len, fmt, args);
+    va_end(args);
+
+    // Truncated lines still end with a newline
+    if(len >= (int)sizeof(line)) {
+        len = sizeof(line) - 1;
+        line[len - 1] = '\n';
     }
-    if(f) storage_file_free(f);
+
+    if(b->log_batch) {
+        if(b->log_batch_len + len > LOG_BATCH_SIZE) log_batch_flush(b);
+        memcpy(b->log_batch + b->log_batch_len, line, len);
+        b->log_batch_len += len;
+        return;
+    }
+    log_append(b, line, len);
+}
+
+// Status names as they appear in bleash.log
+static const char* bt_status_log_name(BtStatus status) {
+    switch(status) {
+    case BtStatusOff:
+        return "Off";
+    case BtStatusAdvertising:
+        return "Advertising";
+    case BtStatusConnected:
+        return "Connected";
+    case BtStatusUnavailable:
+        return "Unavailable";
+    }
+    return "Unknown";
+}
+
+// Indexed by BleashAlert
+static const char* const bleash_alert_log_names[] = {"none", "weak", "disconnect"};
+
+// Longest time between two logged samples under the current profile, rounded up to
+// the RTC's whole seconds. Logged with every sample so readers can tell a quiet
+// stretch from the app not running.
+static uint32_t bleash_log_period_s(Bleash* b) {
+    const BleashPowerProfile* profile = bleash_profile(b);
+    return (profile->sample_interval_ms * profile->log_every_samples + 999) / 1000;
+}
+
+static void log_event(Bleash* b, int8_t rssi, BleashAlert alert) {
+    log_printf(
+        b,
+        "BT=%s RSSI=%d JITTER=%lums PERIOD=%lus ALERT=%s\n",
+        bt_status_log_name(b->bt_status),
+        rssi,
+        b->last_jitter_ticks * 1000 / furi_kernel_get_tick_frequency(),
+        bleash_log_period_s(b),
+        bleash_alert_log_names[alert]);
+}
+
+static void log_exit_latency(Bleash* b, uint32_t latency_ms) {
+    log_printf(b, "EXIT latency=%lums\n", latency_ms);
+}
+
+static void log_calibration(Bleash* b, int8_t percentile_rssi, bool applied) {
+    log_printf(
+        b,
+        "CALIBRATION samples=%lu p%u=%d threshold=%d%s\n",
+        b->calibration.histogram.samples,
+        CALIBRATION_PERCENTILE,
+        percentile_rssi,
+        b->rssi_threshold,
+        applied ? "" : " kept");
+}
+
+static void bleash_calibration_start(Bleash* b) {
+    memset(&b->calibration, 0, sizeof(BleashCalibration));
+    b->calibration.active = true;
+    b->calibration.start_tick = furi_get_tick();
+    FURI_LOG_I(TAG, "Calibration started");
+}
+
+static void bleash_calibration_sample(Bleash* b, int8_t rssi) {
+    if(b->calibration.active) bleash_rssi_histogram_add(&b->calibration.histogram, rssi);
+}
+
+static bool bleash_calibration_due(Bleash* b) {
+    return b->calibration.active && furi_get_tick() - b->calibration.start_tick >=
+                                        furi_ms_to_ticks(CALIBRATION_WINDOW_MS);
+}
+
+// Summary of the accounting window, written when the profile changes or on exit
+static void log_energy_summary(Bleash* b) {
+    uint32_t wakeups_per_minute = 0;
+    uint32_t cost_ua = bleash_energy_estimate_ua(b, &wakeups_per_minute);
+    uint32_t window_s = (furi_get_tick() - b->energy.since_tick) / furi_kernel_get_tick_frequency();
+    uint32_t active_ms = bleash_energy_ticks_to_ms(atomic_load(&b->energy.worker_active_ticks));
+
+    log_printf(
+        b,
+        "ENERGY profile=%s window=%lus active=%lums wakeups/min=%lu storage=%u redraws=%u "
+        "vibro=%ums cost=%luuAh/h\n",
+        bleash_profile(b)->name,
+        window_s,
+        active_ms,
+        wakeups_per_minute,
+        atomic_load(&b->energy.storage_ops),
+        atomic_load(&b->energy.redraws),
+        atomic_load(&b->energy.vibro_ms),
+        cost_ua);
+}
+
+static void log_sched_summary(Bleash* b) {
+    const BleashSchedStats* sched = &b->sched;
+    uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    uint32_t jitter_mean_us =
+        sched->samples ?
+            (uint64_t)sched->jitter_sum_ticks * 1000000 / tick_frequency / sched->samples :
+            0;
+
+    log_printf(
+        b,
+        "SCHED profile=%s samples=%lu jitter_mean=%luus jitter_max=%lums overruns=%lu "
+        "caught_up=%lu skipped=%lu\n",
+        bleash_profile(b)->name,
+        sched->samples,
+        jitter_mean_us,
+        sched->jitter_max_ticks * 1000 / tick_frequency,
+        sched->overruns,
+        sched->caught_up,
+        sched->skipped);
 }
 
 // Helper function to get current RSSI from BLE stack
@@ -199,6 +794,99 @@ static bool bleash_try_connect_known_device(Bleash* bleash) {
     return true;
 }
 
+static void bleash_rollup_reset(BleashRollup* rollup, uint32_t start) {
+    memset(rollup, 0, sizeof(BleashRollup));
+    rollup->active = true;
+    rollup->start = start;
+    rollup->rssi_min = INT8_MAX;
+    rollup->rssi_max = INT8_MIN;
+}
+
+static void bleash_rollup_merge(BleashRollup* into, const BleashRollup* from) {
+    for(size_t i = 0; i < ROLLUP_STATUS_COUNT; i++) {
+        into->status_ms[i] += from->status_ms[i];
+    }
+    into->below_threshold_ms += from->below_threshold_ms;
+    into->rssi_samples += from->rssi_samples;
+    into->rssi_sum += from->rssi_sum;
+    into->disconnects += from->disconnects;
+    if(from->rssi_min < into->rssi_min) into->rssi_min = from->rssi_min;
+    if(from->rssi_max > into->rssi_max) into->rssi_max = from->rssi_max;
+}
+
+static void bleash_rollup_write(Bleash* b, BleashRollupKind kind, const BleashRollup* rollup) {
+    BleashRollupRecord record = {
+        .start = rollup->start,
+        .below_threshold_seconds = rollup->below_threshold_ms / 1000,
+        .rssi_samples = rollup->rssi_samples,
+        .rssi_sum = rollup->rssi_sum,
+        .disconnects = rollup->disconnects,
+        .kind = kind,
+        .rssi_min = rollup->rssi_samples ? rollup->rssi_min : -127,
+        .rssi_max = rollup->rssi_samples ? rollup->rssi_max : -127,
+    };
+    for(size_t i = 0; i < ROLLUP_STATUS_COUNT; i++) {
+        record.status_seconds[i] = rollup->status_ms[i] / 1000;
+    }
+
+    atomic_fetch_add(&b->energy.storage_ops, 1);
+    File* f = storage_file_alloc(b->storage);
+    if(storage_file_open(f, ROLLUP_FILE_PATH, FSAM_WRITE, FSOM_OPEN_ALWAYS | FSOM_OPEN_APPEND)) {
+        storage_file_write(f, &record, sizeof(record));
+        storage_file_close(f);
+    }
+    storage_file_free(f);
+}
+
+// Closes the open hour into the day and writes both, used on exit
+static void bleash_rollup_flush(Bleash* b) {
+    if(!b->rollup_hour.active) return;
+    bleash_rollup_write(b, BleashRollupKindHour, &b->rollup_hour);
+    bleash_rollup_merge(&b->rollup_day, &b->rollup_hour);
+    bleash_rollup_write(b, BleashRollupKindDay, &b->rollup_day);
+    b->rollup_hour.active = false;
+    b->rollup_day.active = false;
+}
+
+// O(1) per sample: the time since the previous sample is credited to this one
+static void bleash_rollup_sample(Bleash* b, BtStatus status, int8_t rssi, bool disconnected) {
+    DateTime dt;
+    furi_hal_rtc_get_datetime(&dt);
+    uint32_t epoch = bleash_datetime_to_epoch(&dt);
+    uint32_t hour_start = epoch - epoch % 3600;
+    uint32_t day_start = epoch - epoch % 86400;
+
+    if(b->rollup_hour.active && b->rollup_hour.start != hour_start) {
+        bleash_rollup_write(b, BleashRollupKindHour, &b->rollup_hour);
+        bleash_rollup_merge(&b->rollup_day, &b->rollup_hour);
+        b->rollup_hour.active = false;
+        if(b->rollup_day.start != day_start) {
+            bleash_rollup_write(b, BleashRollupKindDay, &b->rollup_day);
+            b->rollup_day.active = false;
+        }
+    }
+    if(!b->rollup_hour.active) bleash_rollup_reset(&b->rollup_hour, hour_start);
+    if(!b->rollup_day.active) bleash_rollup_reset(&b->rollup_day, day_start);
+
+    // Gaps longer than two intervals mean monitoring was paused, credit one interval
+    uint32_t now = furi_get_tick();
+    uint32_t interval_ms = bleash_profile(b)->sample_interval_ms;
+    uint32_t elapsed_ms = (now - b->rollup_last_tick) * 1000 / furi_kernel_get_tick_frequency();
+    if(b->rollup_last_tick == 0 || elapsed_ms > 2 * interval_ms) elapsed_ms = interval_ms;
+    b->rollup_last_tick = now;
+
+    BleashRollup* hour = &b->rollup_hour;
+    if(status < ROLLUP_STATUS_COUNT) hour->status_ms[status] += elapsed_ms;
+    if(disconnected) hour->disconnects++;
+    if(status == BtStatusConnected) {
+        hour->rssi_samples++;
+        hour->rssi_sum += rssi;
+        if(rssi < hour->rssi_min) hour->rssi_min = rssi;
+        if(rssi > hour->rssi_max) hour->rssi_max = rssi;
+        if(rssi < b->rssi_threshold) hour->below_threshold_ms += elapsed_ms;
+    }
+}
+
 // Enhanced monitoring function with actual BLE operations
 static void bleash_monitor_connection(Bleash* bleash) {
     if(!bleash || !bleash->background_running) {
@@ -214,9 +902,13 @@ static void bleash_monitor_connection(Bleash* bleash) {
         return;
     }
 
-    // Update connection status
+    BleashAlert alert = BleashAlertNone;
+
+    // Update connection status, a drop between samples counts even if it came back
     bool was_connected = bleash->was_connected;
     bleash->was_connected = (bleash->bt_status == BtStatusConnected);
+    bool link_lost = bleash->bt_link_lost;
+    bleash->bt_link_lost = false;
 
     switch(bleash->bt_status) {
     case BtStatusOff:
@@ -237,20 +929,18 @@ static void bleash_monitor_connection(Bleash* bleash) {
         // Get actual RSSI for connected device
         bleash->last_rssi = bleash_get_rssi(bleash);
         FURI_LOG_D(TAG, "Connected, RSSI: %d dBm", bleash->last_rssi);
+        bleash_calibration_sample(bleash, bleash->last_rssi);
 
-        // Check for weak signal
-        if(bleash->last_rssi < RSSI_THRESHOLD) {
+        // Check for weak signal, the threshold is not trusted while calibrating
+        if(!bleash->calibration.active && bleash->last_rssi < bleash->rssi_threshold) {
             FURI_LOG_W(
-                TAG, "Weak signal: %d dBm (threshold: %d)", bleash->last_rssi, RSSI_THRESHOLD);
-
-            if(bleash->notifications && !bleash->should_exit) {
-                notification_message(bleash->notifications, &sequence_set_vibro_on);
-                furi_delay_ms(200);
-                if(!bleash->should_exit && bleash->notifications) {
-                    notification_message(bleash->notifications, &sequence_reset_vibro);
-                    notification_message(bleash->notifications, &sequence_blink_red_10);
-                }
-            }
+                TAG,
+                "Weak signal: %d dBm (threshold: %d)",
+                bleash->last_rssi,
+                bleash->rssi_threshold);
+
+            alert = BleashAlertWeakSignal;
+            bleash_alert_weak_signal(bleash);
         }
         break;
 
@@ -261,148 +951,271 @@ static void bleash_monitor_connection(Bleash* bleash) {
     }
 
     // Handle connection state changes
-    if(was_connected && !bleash->was_connected) {
+    if(link_lost || (was_connected && !bleash->was_connected)) {
         FURI_LOG_W(TAG, "Device disconnected");
 
-        if(bleash->notifications && !bleash->should_exit) {
-            // Double vibration for disconnection
-            notification_message(bleash->notifications, &sequence_set_vibro_on);
-            furi_delay_ms(150);
-            if(!bleash->should_exit && bleash->notifications) {
-                notification_message(bleash->notifications, &sequence_reset_vibro);
-                furi_delay_ms(100);
-                if(!bleash->should_exit && bleash->notifications) {
-                    notification_message(bleash->notifications, &sequence_set_vibro_on);
-                    furi_delay_ms(150);
-                    if(!bleash->should_exit && bleash->notifications) {
-                        notification_message(bleash->notifications, &sequence_reset_vibro);
-                    }
-                }
-            }
-        }
+        alert = BleashAlertDisconnect;
+        bleash_alert_disconnect(bleash);
 
-        // Restart advertising after disconnection
-        if(bleash_start_scanning(bleash)) {
+        // Restart advertising after disconnection, unless it already reconnected
+        if(!bleash->was_connected && bleash_start_scanning(bleash)) {
             bleash->bt_status = BtStatusAdvertising;
         }
     } else if(!was_connected && bleash->was_connected) {
         FURI_LOG_I(TAG, "Device connected");
 
-        if(bleash->notifications && !bleash->should_exit) {
+        if(bleash->notifications && !atomic_load(&bleash->should_exit)) {
             notification_message(bleash->notifications, &sequence_blink_green_10);
         }
     }
 
-    // Log the event
-    log_event(bleash, bleash->last_rssi);
+    bleash_rollup_sample(
+        bleash, bleash->bt_status, bleash->last_rssi, alert == BleashAlertDisconnect);
+
+    if(bleash_log_due(
+           bleash,
+           alert != BleashAlertNone || bleash->bt_status != bleash->last_logged_status)) {
+        log_event(bleash, bleash->last_rssi, alert);
+        bleash->last_logged_status = bleash->bt_status;
+    }
 }
 
-static void bt_status_changed_callback(BtStatus status, void* context) {
-    Bleash* bleash = context;
+static uint32_t bleash_now_ms(void) {
+    return (uint64_t)furi_get_tick() * 1000 / furi_kernel_get_tick_frequency();
+}
 
-    // More robust safety checks
-    if(!bleash) {
-        return;
+static void bleash_observer_watch_line(Bleash* bleash, const char* line) {
+    uint8_t addr[BLEASH_OBSERVER_ADDR_LEN];
+    if(strlen(line) >= 17 && bleash_observer_parse_addr(line, addr)) {
+        bleash_observer_add_target(&bleash->observer, addr);
     }
+}
 
-    // Check if we're shutting down or processing
-    if(bleash->should_exit || bleash->processing) {
-        return;
-    }
+// Reads one "AA:BB:CC:DD:EE:FF" address per line, anything else is ignored
+static void bleash_observer_load_watchlist(Bleash* bleash) {
+    bleash_observer_init(&bleash->observer);
 
-    // Check if mutex is still valid
-    if(!bleash->mutex) {
-        return;
+    File* file = storage_file_alloc(bleash->storage);
+    if(storage_file_open(file, WATCHLIST_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        char chunk[64];
+        char line[24];
+        size_t line_len = 0;
+        size_t read;
+        while((read = storage_file_read(file, chunk, sizeof(chunk))) > 0) {
+            for(size_t i = 0; i < read; i++) {
+                if(chunk[i] != '\n') {
+                    if(line_len < sizeof(line) - 1) line[line_len++] = chunk[i];
+                    continue;
+                }
+                line[line_len] = '\0';
+                bleash_observer_watch_line(bleash, line);
+                line_len = 0;
+            }
+        }
+        line[line_len] = '\0';
+        bleash_observer_watch_line(bleash, line);
+        storage_file_close(file);
     }
+    storage_file_free(file);
 
-    // Try to acquire mutex with timeout, if it fails we're probably shutting down
-    if(furi_mutex_acquire(bleash->mutex, 50) != FuriStatusOk) {
-        return;
-    }
+    FURI_LOG_I(TAG, "Watching %u targets", bleash->observer.count);
+}
 
-    // Double-check we're not shutting down after acquiring mutex
-    if(!bleash->should_exit && !bleash->processing) {
-        bleash->bt_status = status;
-        bleash->was_connected = (status == BtStatusConnected);
-        FURI_LOG_I(TAG, "BT status changed to %d", status);
+static void bleash_adv_source_close(Bleash* bleash) {
+    if(bleash->adv_source.file) {
+        storage_file_close(bleash->adv_source.file);
+        storage_file_free(bleash->adv_source.file);
+        bleash->adv_source.file = NULL;
     }
-
-    furi_mutex_release(bleash->mutex);
 }
 
-static void draw_battery_indicator(Canvas* canvas, int x, int y, int8_t rssi) {
-    uint8_t bars = ((rssi + 130) / 10);
-    if(bars > 5) bars = 5;
+static bool bleash_adv_source_open(Bleash* bleash) {
+    BleashAdvSource* source = &bleash->adv_source;
+    memset(source, 0, sizeof(BleashAdvSource));
+    source->file = storage_file_alloc(bleash->storage);
+    if(!storage_file_open(source->file, ADV_REPLAY_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_W(TAG, "No advertisement capture at %s", ADV_REPLAY_FILE_PATH);
+        storage_file_free(source->file);
+        source->file = NULL;
+        return false;
+    }
+    source->start_ms = bleash_now_ms();
+    return true;
+}
 
-    canvas_draw_frame(canvas, x, y, 15, 8);
-    canvas_draw_box(canvas, x + 15, y + 2, 2, 4);
+// Feeds every report due by now into the observer, a batch of records per SD read
+static void bleash_adv_source_poll(Bleash* bleash, uint32_t now_ms) {
+    BleashAdvSource* source = &bleash->adv_source;
+    if(!source->file) return;
+
+    while(true) {
+        if(source->batch_pos == source->batch_count) {
+            atomic_fetch_add(&bleash->energy.storage_ops, 1);
+            size_t read = storage_file_read(source->file, source->batch, sizeof(source->batch));
+            source->batch_count = read / sizeof(BleashAdvReport);
+            source->batch_pos = 0;
+            if(source->batch_count == 0) {
+                // Loop the capture, continuing from where its timeline ended. A
+                // capture without a timeline would spin here, drop it instead.
+                if(source->last_time_ms == 0 || !storage_file_seek(source->file, 0, true)) {
+                    bleash_adv_source_close(bleash);
+                    return;
+                }
+                source->start_ms += source->last_time_ms;
+                source->last_time_ms = 0;
+                continue;
+            }
+        }
 
-    for(uint8_t i = 0; i < bars; i++) {
-        canvas_draw_box(canvas, x + 2 + (i * 3), y + 2, 2, 4);
+        const BleashAdvReport* report = &source->batch[source->batch_pos];
+        if(now_ms - source->start_ms < report->time_ms) return;
+        bleash_observer_ingest(
+            &bleash->observer, report->addr, report->rssi, source->start_ms + report->time_ms);
+        source->last_time_ms = report->time_ms;
+        source->batch_pos++;
     }
 }
 
-static void draw_status_view(Canvas* canvas, Bleash* bleash) {
-    canvas_clear(canvas);
-    canvas_set_font(canvas, FontSecondary);
+static void bleash_observer_stop(Bleash* bleash) {
+    bleash_adv_source_close(bleash);
+    bleash->observer_ready = false;
+    bleash->observer_present = 0;
+}
 
-    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, BLE_APP_NAME);
-    canvas_draw_line(canvas, 0, 11, 128, 11);
+static void log_observer_event(Bleash* b, uint8_t present, int8_t rssi, BleashAlert alert) {
+    log_printf(
+        b,
+        "OBS=%u/%u RSSI=%d JITTER=%lums PERIOD=%lus ALERT=%s\n",
+        present,
+        b->observer.count,
+        rssi,
+        b->last_jitter_ticks * 1000 / furi_kernel_get_tick_frequency(),
+        bleash_log_period_s(b),
+        bleash_alert_log_names[alert]);
+}
 
-    const char* status_str = "Unknown";
-    switch(bleash->bt_status) {
-    case BtStatusOff:
-        status_str = "BT Off";
-        break;
-    case BtStatusAdvertising:
-        status_str = "Advertising";
-        break;
-    case BtStatusConnected:
-        status_str = "Connected";
-        break;
-    case BtStatusUnavailable:
-        status_str = "Unavailable";
-        break;
+// Passive counterpart of bleash_monitor_connection: a target that was present and
+// has not been heard from for OBSERVER_LOST_TIMEOUT_MS is a leash break
+static void bleash_monitor_observer(Bleash* bleash) {
+    if(!bleash->observer_ready) {
+        bleash_observer_load_watchlist(bleash);
+        bleash_adv_source_open(bleash);
+        bleash->observer_ready = true;
     }
 
-    canvas_draw_str(canvas, 2, 24, status_str);
+    uint32_t now_ms = bleash_now_ms();
+    bleash_adv_source_poll(bleash, now_ms);
+
+    uint16_t present = 0;
+    uint8_t present_count = 0;
+    int8_t weakest = -127;
+    for(uint8_t i = 0; i < bleash->observer.count; i++) {
+        const BleashObserverTarget* target = &bleash->observer.targets[i];
+        if(bleash_observer_target_lost(target, now_ms, OBSERVER_LOST_TIMEOUT_MS)) continue;
+        int8_t rssi = bleash_observer_target_rssi(target);
+        if(!present || rssi < weakest) weakest = rssi;
+        present |= 1U << i;
+        present_count++;
+    }
 
-    if(bleash->bt_status == BtStatusConnected || bleash->last_rssi > -127) {
-        char rssi_str[32];
-        snprintf(rssi_str, sizeof(rssi_str), "Signal: %d dBm", bleash->last_rssi);
-        canvas_draw_str(canvas, 2, 36, rssi_str);
+    if(present) bleash_calibration_sample(bleash, weakest);
+
+    uint16_t lost = bleash->observer_present & ~present;
+    uint16_t found = present & ~bleash->observer_present;
+    bleash->observer_present = present;
+    bleash->last_rssi = weakest;
+    BleashAlert alert = BleashAlertNone;
+
+    FURI_LOG_D(
+        TAG,
+        "Observer: %u/%u present, %lu/%lu reports matched",
+        present_count,
+        bleash->observer.count,
+        bleash->observer.reports_matched,
+        bleash->observer.reports_total);
+
+    if(lost) {
+        FURI_LOG_W(TAG, "Target lost (mask 0x%04X)", lost);
+        alert = BleashAlertDisconnect;
+        bleash_alert_disconnect(bleash);
+    } else if(present && !bleash->calibration.active && weakest < bleash->rssi_threshold) {
+        FURI_LOG_W(TAG, "Weak target: %d dBm (threshold: %d)", weakest, bleash->rssi_threshold);
+        alert = BleashAlertWeakSignal;
+        bleash_alert_weak_signal(bleash);
+    } else if(found && bleash->notifications && !atomic_load(&bleash->should_exit)) {
+        notification_message(bleash->notifications, &sequence_blink_green_10);
+    }
 
-        draw_battery_indicator(canvas, 90, 29, bleash->last_rssi);
+    if(bleash_log_due(
+           bleash, alert != BleashAlertNone || present_count != bleash->logged_present_count)) {
+        log_observer_event(bleash, present_count, weakest, alert);
+        bleash->logged_present_count = present_count;
     }
+}
 
-    canvas_set_font(canvas, FontPrimary);
-    if(bleash->background_running) {
-        canvas_draw_str_aligned(canvas, 64, 42, AlignCenter, AlignCenter, "Monitoring ON");
-    } else {
-        canvas_draw_str_aligned(canvas, 64, 42, AlignCenter, AlignCenter, "Monitoring OFF");
+static void bt_status_changed_callback(BtStatus status, void* context) {
+    Bleash* bleash = context;
+
+    // Bail out early if we're shutting down
+    if(!bleash || !bleash_callback_enter(bleash, false)) {
+        return;
     }
 
-    canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str(canvas, 2, 55, "OK: Toggle");
-    canvas_draw_str_aligned(canvas, 126, 55, AlignRight, AlignBottom, "Back: Hide");
-    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "Long Back: Exit");
+    // Runs on the BT service thread: hand the change to the worker without blocking
+    bleash_bt_mailbox_publish(bleash, status);
+
+    bleash_callback_leave(bleash);
+}
+
+_Static_assert(
+    BtStatusUnavailable == 0 && BtStatusOff == 1 && BtStatusAdvertising == 2 &&
+        BtStatusConnected == 3,
+    "bleash_view status names are indexed by BtStatus");
+
+static void bleash_view_model(Bleash* bleash, BleashViewModel* model) {
+    memset(model, 0, sizeof(BleashViewModel));
+    model->title = BLE_APP_NAME;
+    model->status = bleash->bt_status;
+    model->observer = bleash->leash_mode == BleashLeashModeObserver;
+    if(model->observer) {
+        model->watchlist_empty = bleash->observer_ready && bleash->observer.count == 0;
+        model->present = __builtin_popcount(bleash->observer_present);
+        model->targets = bleash->observer.count;
+    }
+    model->profile_name = bleash_profile(bleash)->name;
+    // Quantised to the 0.01 mAh/h shown, finer changes must not force a redraw
+    uint32_t cost_ua = bleash_energy_estimate_ua(bleash, NULL);
+    model->cost_ua = cost_ua - cost_ua % 10;
+
+    bool connected = !model->observer && bleash->bt_status == BtStatusConnected;
+    model->show_signal = connected || bleash->last_rssi > -127;
+    model->rssi = model->show_signal ? bleash->last_rssi : -127;
+    model->running = bleash->background_running;
+
+    if(bleash->calibration.active) {
+        uint32_t elapsed_ms = (furi_get_tick() - bleash->calibration.start_tick) * 1000 /
+                              furi_kernel_get_tick_frequency();
+        uint32_t left_ms = elapsed_ms < CALIBRATION_WINDOW_MS ?
+                               CALIBRATION_WINDOW_MS - elapsed_ms :
+                               0;
+        // Never 0 while active, the worker ends calibration on its next pass
+        model->calibration_left_s = left_ms / 1000 + 1;
+    }
 }
 
 static void bleash_update_timer_callback(void* context) {
     Bleash* bleash = context;
 
     // Safety checks to prevent use-after-free
-    if(!bleash || bleash->should_exit || bleash->processing) {
-        return;
-    }
-
-    // Check if event queue is still valid
-    if(!bleash->event_queue) {
+    if(!bleash || !bleash_callback_enter(bleash, true)) {
         return;
     }
 
+    atomic_fetch_add(&bleash->energy.wakeups, 1);
     BleashEvent event = {.type = BleashEventTypeTick};
     furi_message_queue_put(bleash->event_queue, &event, 0);
+
+    bleash_callback_leave(bleash);
 }
 
 static void draw_callback(Canvas* canvas, void* ctx) {
@@ -418,20 +1231,30 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     }
 
     // Only show loading during shutdown/cleanup
-    if(b->should_exit || b->processing) {
+    if(!bleash_callback_enter(b, true)) {
         canvas_clear(canvas);
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str_aligned(canvas, 64, 32, AlignCenter, AlignCenter, "Shutting down...");
         return;
     }
 
-    draw_status_view(canvas, b);
+    atomic_fetch_add(&b->energy.redraws, 1);
+    BleashViewModel model;
+    bleash_view_model(b, &model);
+    bleash_view_draw(canvas, &b->view_cache, &model);
+    bleash_callback_leave(b);
 }
 
 static void save_state(Bleash* b) {
+    atomic_fetch_add(&b->energy.storage_ops, 1);
     File* file = storage_file_alloc(b->storage);
     if(storage_file_open(file, STATE_FILE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        uint8_t profile = b->power_profile;
+        uint8_t mode = b->leash_mode;
         storage_file_write(file, &b->background_running, sizeof(bool));
+        storage_file_write(file, &profile, sizeof(profile));
+        storage_file_write(file, &mode, sizeof(mode));
+        storage_file_write(file, &b->rssi_threshold, sizeof(int8_t));
         storage_file_close(file);
     }
     storage_file_free(file);
@@ -440,12 +1263,53 @@ static void save_state(Bleash* b) {
 static void load_state(Bleash* b) {
     File* file = storage_file_alloc(b->storage);
     if(storage_file_open(file, STATE_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint8_t profile = DEFAULT_POWER_PROFILE;
+        uint8_t mode = BleashLeashModeConnection;
+        int8_t threshold = RSSI_THRESHOLD;
         storage_file_read(file, &b->background_running, sizeof(bool));
+        // State files from older versions end after the monitoring flag, profile or mode
+        if(storage_file_read(file, &profile, sizeof(profile)) == sizeof(profile) &&
+           profile < BleashPowerProfileCount) {
+            b->power_profile = profile;
+        }
+        if(storage_file_read(file, &mode, sizeof(mode)) == sizeof(mode) &&
+           mode < BleashLeashModeCount) {
+            b->leash_mode = mode;
+        }
+        if(storage_file_read(file, &threshold, sizeof(threshold)) == sizeof(threshold) &&
+           threshold >= CALIBRATION_MIN_DBM && threshold <= CALIBRATION_MAX_DBM) {
+            b->rssi_threshold = threshold;
+        }
         storage_file_close(file);
     }
     storage_file_free(file);
 }
 
+// Worker, with the mutex held
+static void bleash_calibration_finish(Bleash* b) {
+    b->calibration.active = false;
+    const BleashRssiHistogram* histogram = &b->calibration.histogram;
+    int8_t percentile_rssi = bleash_rssi_histogram_percentile(histogram, CALIBRATION_PERCENTILE);
+    bool applied = histogram->samples >= CALIBRATION_MIN_SAMPLES;
+
+    if(applied) {
+        int32_t threshold = percentile_rssi - CALIBRATION_MARGIN_DB;
+        if(threshold < CALIBRATION_MIN_DBM) threshold = CALIBRATION_MIN_DBM;
+        if(threshold > CALIBRATION_MAX_DBM) threshold = CALIBRATION_MAX_DBM;
+        b->rssi_threshold = (int8_t)threshold;
+        save_state(b);
+        FURI_LOG_I(TAG, "Calibrated threshold: %d dBm", b->rssi_threshold);
+    } else {
+        FURI_LOG_W(TAG, "Calibration got %lu samples, threshold kept", histogram->samples);
+    }
+    log_calibration(b, percentile_rssi, applied);
+
+    if(b->notifications && !atomic_load(&b->should_exit)) {
+        notification_message(
+            b->notifications, applied ? &sequence_blink_green_10 : &sequence_blink_red_10);
+    }
+}
+
 static bool check_instance_running(Bleash* b) {
     File* file = storage_file_alloc(b->storage);
     bool exists = storage_file_open(file, INSTANCE_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
@@ -493,43 +1357,420 @@ static void remove_instance_file(Bleash* b) {
     }
 }
 
+static bool bleash_parse_digits(const char* s, size_t count, uint32_t* value) {
+    *value = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(s[i] < '0' || s[i] > '9') return false;
+        *value = *value * 10 + (s[i] - '0');
+    }
+    return true;
+}
+
+// Parses "YYYY-MM-DD HH:MM:SS: BT=Status RSSI=Value ... PERIOD=Ns ALERT=Kind" and the
+// observer "OBS=present/total" form, other log lines are rejected. PERIOD= and ALERT=
+// are optional so older logs still export.
+static bool bleash_parse_log_line(const char* line, size_t len, BleashLogSample* sample) {
+    if(len < 25 || line[4] != '-' || line[7] != '-' || line[10] != ' ' || line[13] != ':' ||
+       line[16] != ':') {
+        return false;
+    }
+    sample->observer = strncmp(&line[19], ": OBS=", 6) == 0;
+    if(!sample->observer && strncmp(&line[19], ": BT=", 5) != 0) return false;
+
+    uint32_t year, month, day, hour, minute, second;
+    if(!bleash_parse_digits(&line[0], 4, &year) || !bleash_parse_digits(&line[5], 2, &month) ||
+       !bleash_parse_digits(&line[8], 2, &day) || !bleash_parse_digits(&line[11], 2, &hour) ||
+       !bleash_parse_digits(&line[14], 2, &minute) ||
+       !bleash_parse_digits(&line[17], 2, &second) || month < 1 || month > 12) {
+        return false;
+    }
+
+    const char* status = &line[sample->observer ? 25 : 24];
+    const char* rssi = strstr(status, " RSSI=");
+    if(!rssi) return false;
+    size_t status_len = rssi - status;
+
+    if(sample->observer) {
+        const char* slash = memchr(status, '/', status_len);
+        if(!slash) return false;
+        sample->status = BtStatusOff;
+        sample->present = (uint8_t)atoi(status);
+        sample->targets = (uint8_t)atoi(slash + 1);
+    } else {
+        static const BtStatus statuses[] = {
+            BtStatusOff, BtStatusAdvertising, BtStatusConnected, BtStatusUnavailable};
+        bool found = false;
+        for(size_t i = 0; i < COUNT_OF(statuses); i++) {
+            const char* name = bt_status_log_name(statuses[i]);
+            if(strlen(name) == status_len && strncmp(status, name, status_len) == 0) {
+                sample->status = statuses[i];
+                found = true;
+                break;
+            }
+        }
+        if(!found) return false;
+        sample->present = 0;
+        sample->targets = 0;
+    }
+
+    DateTime dt = {
+        .year = year, .month = month, .day = day, .hour = hour, .minute = minute, .second = second};
+    sample->timestamp = bleash_datetime_to_epoch(&dt);
+    sample->rssi = (int8_t)atoi(rssi + 6);
+
+    const char* period = strstr(rssi, " PERIOD=");
+    sample->period_s = period ? (uint16_t)atoi(period + 8) : 0;
+
+    sample->has_alert = false;
+    const char* alert = strstr(rssi, " ALERT=");
+    if(alert) {
+        alert += 7;
+        for(size_t i = 0; i < COUNT_OF(bleash_alert_log_names); i++) {
+            if(strcmp(alert, bleash_alert_log_names[i]) == 0) {
+                sample->alert = (BleashAlert)i;
+                sample->has_alert = true;
+                break;
+            }
+        }
+        if(!sample->has_alert) return false;
+    }
+    return true;
+}
+
+// Appends the lines logged while an export ran to the snapshot and puts it back as
+// bleash.log. Also run at startup in case an export was interrupted by a crash.
+static void bleash_log_snapshot_restore(Bleash* b) {
+    if(!storage_file_exists(b->storage, LOG_SNAPSHOT_FILE_PATH)) return;
+
+    if(storage_file_exists(b->storage, LOG_FILE_PATH)) {
+        File* snapshot = storage_file_alloc(b->storage);
+        File* recent = storage_file_alloc(b->storage);
+        uint8_t* buffer = malloc(EXPORT_CHUNK_SIZE);
+        bool ok = false;
+        if(storage_file_open(
+               snapshot,
+               LOG_SNAPSHOT_FILE_PATH,
+               FSAM_WRITE,
+               FSOM_OPEN_ALWAYS | FSOM_OPEN_APPEND) &&
+           storage_file_open(recent, LOG_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            ok = true;
+            size_t read;
+            while(ok && (read = storage_file_read(recent, buffer, EXPORT_CHUNK_SIZE)) > 0) {
+                atomic_fetch_add(&b->energy.storage_ops, 1);
+                ok = storage_file_write(snapshot, buffer, read) == read;
+            }
+        }
+        storage_file_close(recent);
+        storage_file_close(snapshot);
+        storage_file_free(recent);
+        storage_file_free(snapshot);
+        free(buffer);
+        if(!ok) {
+            FURI_LOG_E(TAG, "Failed to merge the log back after export");
+            return;
+        }
+        storage_common_remove(b->storage, LOG_FILE_PATH);
+    }
+    storage_common_rename(b->storage, LOG_SNAPSHOT_FILE_PATH, LOG_FILE_PATH);
+}
+
+static bool bleash_export_cancelled(Bleash* b) {
+    return atomic_load(&b->should_exit) || !atomic_load(&b->running);
+}
+
+// Single pass over bleash.log with constant memory: one input chunk, one output
+// chunk and one line buffer, whatever the size of the log. The log is moved aside
+// for the export so the worker keeps appending to a fresh bleash.log meanwhile, and
+// the export reads it through a single open handle.
+static bool bleash_export_log(Bleash* b, BleashExportFormat format) {
+    if(!storage_dir_exists(b->storage, EXPORT_FOLDER_PATH) &&
+       storage_common_mkdir(b->storage, EXPORT_FOLDER_PATH) != FSE_OK) {
+        FURI_LOG_E(TAG, "Failed to create export directory");
+        return false;
+    }
+
+    // Same epoch conversion as the exported rows
+    DateTime now;
+    furi_hal_rtc_get_datetime(&now);
+    char path[64];
+    snprintf(
+        path,
+        sizeof(path),
+        "%s/bleash_%lu.%s",
+        EXPORT_FOLDER_PATH,
+        bleash_datetime_to_epoch(&now),
+        format == BleashExportFormatCsv ? "csv" : "jsonl");
+
+    File* input = storage_file_alloc(b->storage);
+    File* output = storage_file_alloc(b->storage);
+    if(!storage_file_open(output, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to open %s", path);
+        storage_file_free(output);
+        storage_file_free(input);
+        return false;
+    }
+
+    furi_mutex_acquire(b->mutex, FuriWaitForever);
+    bool snapshot =
+        storage_common_rename(b->storage, LOG_FILE_PATH, LOG_SNAPSHOT_FILE_PATH) == FSE_OK;
+    furi_mutex_release(b->mutex);
+    if(!snapshot ||
+       !storage_file_open(input, LOG_SNAPSHOT_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "No log to export");
+        storage_file_close(output);
+        storage_common_remove(b->storage, path);
+        storage_file_free(output);
+        storage_file_free(input);
+        if(snapshot) {
+            furi_mutex_acquire(b->mutex, FuriWaitForever);
+            bleash_log_snapshot_restore(b);
+            furi_mutex_release(b->mutex);
+        }
+        return false;
+    }
+
+    uint8_t* in_buf = malloc(EXPORT_CHUNK_SIZE);
+    char* out_buf = malloc(EXPORT_CHUNK_SIZE);
+    char line[EXPORT_LINE_MAX];
+    size_t line_len = 0;
+    size_t out_len = 0;
+    bool line_overflow = false;
+    bool was_connected = false;
+    uint8_t last_present = 0;
+    bool ok = true;
+    bool cancelled = false;
+    uint32_t rows = 0;
+
+    if(format == BleashExportFormatCsv) {
+        out_len = snprintf(
+            out_buf, EXPORT_CHUNK_SIZE, "timestamp,status,rssi,alert,period,present\n");
+    }
+
+    size_t read;
+    while(ok && (read = storage_file_read(input, in_buf, EXPORT_CHUNK_SIZE)) > 0) {
+        atomic_fetch_add(&b->energy.storage_ops, 1);
+        // Back or Long Back must not wait for a long export to finish
+        if(bleash_export_cancelled(b)) {
+            cancelled = true;
+            break;
+        }
+        for(size_t i = 0; i < read; i++) {
+            char c = in_buf[i];
+            if(c != '\n') {
+                if(line_len < sizeof(line) - 1) {
+                    line[line_len++] = c;
+                } else {
+                    line_overflow = true;
+                }
+                continue;
+            }
+
+            line[line_len] = '\0';
+            BleashLogSample sample;
+            if(!line_overflow && bleash_parse_log_line(line, line_len, &sample)) {
+                bool connected = !sample.observer && sample.status == BtStatusConnected;
+                bool present = sample.observer && sample.present > 0;
+                BleashAlert alert = sample.alert;
+                if(!sample.has_alert) {
+                    // Older lines: approximate the alert from consecutive samples
+                    alert = BleashAlertNone;
+                    if((was_connected && !connected && !sample.observer) ||
+                       (sample.observer && sample.present < last_present)) {
+                        alert = BleashAlertDisconnect;
+                    } else if((connected || present) && sample.rssi < b->rssi_threshold) {
+                        alert = BleashAlertWeakSignal;
+                    }
+                }
+                was_connected = connected;
+                last_present = sample.observer ? sample.present : 0;
+
+                int status = sample.status;
+                if(sample.observer) {
+                    status = present && sample.present == sample.targets ?
+                                 EXPORT_STATUS_OBSERVER_ALL :
+                                 EXPORT_STATUS_OBSERVER_MISSING;
+                }
+
+                if(out_len + EXPORT_LINE_MAX > EXPORT_CHUNK_SIZE) {
+                    atomic_fetch_add(&b->energy.storage_ops, 1);
+                    ok = storage_file_write(output, out_buf, out_len) == out_len;
+                    out_len = 0;
+                }
+                out_len += snprintf(
+                    out_buf + out_len,
+                    EXPORT_CHUNK_SIZE - out_len,
+                    format == BleashExportFormatCsv ?
+                        "%lu,%d,%d,%d,%u,%u\n" :
+                        "{\"t\":%lu,\"status\":%d,\"rssi\":%d,\"alert\":%d,\"period\":%u,"
+                        "\"present\":%u}\n",
+                    sample.timestamp,
+                    status,
+                    sample.rssi,
+                    alert,
+                    sample.period_s,
+                    sample.present);
+                rows++;
+            }
+            line_len = 0;
+            line_overflow = false;
+        }
+    }
+
+    if(ok && !cancelled && out_len > 0) {
+        ok = storage_file_write(output, out_buf, out_len) == out_len;
+    }
+
+    storage_file_close(input);
+    storage_file_close(output);
+    storage_file_free(output);
+    storage_file_free(input);
+    free(out_buf);
+    free(in_buf);
+
+    furi_mutex_acquire(b->mutex, FuriWaitForever);
+    bleash_log_snapshot_restore(b);
+    furi_mutex_release(b->mutex);
+
+    if(cancelled || !ok) {
+        storage_common_remove(b->storage, path);
+        FURI_LOG_W(TAG, "Export %s, removed %s", cancelled ? "cancelled" : "failed", path);
+        return false;
+    }
+    FURI_LOG_I(TAG, "Exported %lu samples to %s", rows, path);
+    return true;
+}
+
+static int32_t bleash_export_thread(void* context) {
+    Bleash* b = context;
+    bool exported = bleash_export_log(b, b->export_format);
+    if(!bleash_export_cancelled(b)) {
+        notification_message(
+            b->notifications, exported ? &sequence_blink_green_10 : &sequence_blink_red_10);
+    }
+    atomic_store(&b->exporting, false);
+    return 0;
+}
+
+// Exports run on their own thread so the GUI and exit stay responsive
+static void bleash_export_start(Bleash* b, BleashExportFormat format) {
+    if(atomic_load(&b->exporting)) {
+        FURI_LOG_W(TAG, "Export already running");
+        return;
+    }
+    if(b->export_thread) {
+        furi_thread_join(b->export_thread);
+        furi_thread_free(b->export_thread);
+    }
+
+    b->export_format = format;
+    atomic_store(&b->exporting, true);
+    b->export_thread =
+        furi_thread_alloc_ex("BleashExport", EXPORT_THREAD_STACK, bleash_export_thread, b);
+    furi_thread_start(b->export_thread);
+}
+
+// Teardown: running is already false, so a running export stops at its next chunk
+static void bleash_export_stop(Bleash* b) {
+    if(!b->export_thread) return;
+    furi_thread_join(b->export_thread);
+    furi_thread_free(b->export_thread);
+    b->export_thread = NULL;
+}
+
 static int32_t bleash_worker(void* context) {
     Bleash* bleash = context;
     if(!bleash) return -1;
 
     FURI_LOG_I(TAG, "Worker thread started");
+    atomic_store(&bleash->worker_id, furi_thread_get_current_id());
+
+    // Samples are scheduled on absolute tick deadlines so that pass duration (alerts,
+    // SD writes) does not stretch the period
+    uint32_t deadline = furi_get_tick();
+    uint8_t catch_up = 0;
 
-    while(!bleash->should_exit) {
+    while(!atomic_load(&bleash->should_exit)) {
         // Check if essential resources are still valid
         if(!bleash->mutex || !bleash->notifications) {
             FURI_LOG_E(TAG, "Essential resources are null, exiting worker");
             break;
         }
 
-        // Check if we should exit before acquiring mutex
-        if(bleash->should_exit) break;
-
         furi_mutex_acquire(bleash->mutex, FuriWaitForever);
 
         // Double-check exit condition after acquiring mutex
-        if(bleash->should_exit) {
+        if(atomic_load(&bleash->should_exit)) {
             furi_mutex_release(bleash->mutex);
             break;
         }
 
+        uint32_t pass_start = furi_get_tick();
+        bleash->worker_wait_ticks = 0;
+        bleash_bt_mailbox_drain(bleash);
+
         if(bleash->background_running) {
-            // Use the new enhanced monitoring function
-            bleash_monitor_connection(bleash);
+            BleashSchedStats* sched = &bleash->sched;
+            uint32_t jitter = pass_start - deadline;
+            bleash->last_jitter_ticks = jitter;
+            sched->samples++;
+            sched->jitter_sum_ticks += jitter;
+            if(jitter > sched->jitter_max_ticks) sched->jitter_max_ticks = jitter;
+
+            if(bleash->leash_mode == BleashLeashModeObserver) {
+                bleash_monitor_observer(bleash);
+            } else {
+                bleash_monitor_connection(bleash);
+            }
         }
+        // A drop only matters to the connection leash while it is monitoring
+        bleash->bt_link_lost = false;
 
-        furi_mutex_release(bleash->mutex);
+        if(bleash_calibration_due(bleash)) {
+            bleash_calibration_finish(bleash);
+        }
 
-        // Use shorter delays with exit checking
-        for(int i = 0; i < POLL_INTERVAL_MS / 100 && !bleash->should_exit; i++) {
-            furi_delay_ms(100);
+        const BleashPowerProfile* profile = bleash_profile(bleash);
+        uint32_t now = furi_get_tick();
+        atomic_fetch_add(
+            &bleash->energy.worker_active_ticks, now - pass_start - bleash->worker_wait_ticks);
+
+        uint32_t interval = furi_ms_to_ticks(profile->sample_interval_ms);
+        deadline += interval;
+        int32_t late = (int32_t)(now - deadline);
+        bool catching_up = false;
+        if(late >= 0) {
+            // This pass ran into the next slot
+            bleash->sched.overruns++;
+            if(profile->overrun_policy == BleashOverrunCatchUp &&
+               catch_up < SCHED_MAX_CATCH_UP) {
+                catch_up++;
+                bleash->sched.caught_up++;
+                catching_up = true;
+            } else {
+                // Skip, or catch-up exhausted: move to the first future slot on the grid
+                uint32_t missed = (uint32_t)late / interval + 1;
+                bleash->sched.skipped += missed;
+                deadline += missed * interval;
+            }
         }
+
+        furi_mutex_release(bleash->mutex);
+
+        if(catching_up) continue;
+        catch_up = 0;
+
+        // Sleep until the next deadline, exit flag wakes us immediately
+        if(!bleash_worker_sleep_until(bleash, deadline)) break;
     }
 
+    furi_mutex_acquire(bleash->mutex, FuriWaitForever);
+    bleash_observer_stop(bleash);
+    furi_mutex_release(bleash->mutex);
+
+    // A BT callback that already read worker_id may still set flags on this thread
+    atomic_store(&bleash->worker_id, NULL);
+    bleash_drain_callbacks(bleash);
+
     FURI_LOG_I(TAG, "Worker thread stopping");
     return 0;
 }
@@ -538,7 +1779,7 @@ static void input_callback(InputEvent* event, void* ctx) {
     Bleash* b = ctx;
 
     // Safety checks
-    if(!b || !event) {
+    if(!b || !event || !bleash_callback_enter(b, true)) {
         return;
     }
 
@@ -560,15 +1801,33 @@ static void input_callback(InputEvent* event, void* ctx) {
             }
         } else if(event->key == InputKeyBack) {
             FURI_LOG_I(TAG, "Back pressed - hiding GUI");
-            b->running = false;
+            atomic_store(&b->running, false);
+        } else if(
+            event->key == InputKeyRight || event->key == InputKeyUp ||
+            event->key == InputKeyLeft || event->key == InputKeyDown) {
+            // Export, profile, mode and calibration touch the SD card, hand them to the main loop
+            BleashEvent key_event = {.type = BleashEventTypeKey, .input = *event};
+            furi_message_queue_put(b->event_queue, &key_event, 0);
         }
     } else if(event->type == InputTypeLong) {
         if(event->key == InputKeyBack) {
             FURI_LOG_I(TAG, "Long back pressed - full exit");
-            b->should_exit = true;
-            b->running = false;
+            b->exit_request_tick = furi_get_tick();
+            bleash_worker_signal_exit(b);
+            atomic_store(&b->running, false);
+        } else if(event->key == InputKeyRight) {
+            BleashEvent key_event = {.type = BleashEventTypeKey, .input = *event};
+            furi_message_queue_put(b->event_queue, &key_event, 0);
         }
     }
+
+    // Wake the main loop right away instead of waiting for the queue timeout
+    if(!atomic_load(&b->running)) {
+        BleashEvent exit_event = {.type = BleashEventTypeExit};
+        furi_message_queue_put(b->event_queue, &exit_event, 0);
+    }
+
+    bleash_callback_leave(b);
 }
 
 static bool bleash_init_storage(Bleash* app) {
@@ -579,6 +1838,8 @@ static bool bleash_init_storage(Bleash* app) {
             return false;
         }
     }
+    // A crash during an export leaves the log moved aside
+    bleash_log_snapshot_restore(app);
     return true;
 }
 
@@ -586,6 +1847,7 @@ int32_t BLEASH(void* p) {
     UNUSED(p);
     Bleash* bleash = malloc(sizeof(Bleash));
     memset(bleash, 0, sizeof(Bleash));
+    bleash_view_cache_init(&bleash->view_cache);
 
     bleash->storage = furi_record_open(RECORD_STORAGE);
     if(!bleash_init_storage(bleash)) {
@@ -645,7 +1907,11 @@ int32_t BLEASH(void* p) {
         FURI_LOG_W(TAG, "BT GATT/GAP not supported on this device");
     }
 
+    bleash->power_profile = DEFAULT_POWER_PROFILE;
+    bleash->rssi_threshold = RSSI_THRESHOLD;
     load_state(bleash);
+    bleash_energy_reset(bleash);
+    bleash_sched_reset(bleash);
     bleash->last_rssi = -127;
     bleash->was_connected = false;
     bleash->bt_status = BtStatusOff;
@@ -672,16 +1938,16 @@ int32_t BLEASH(void* p) {
     view_port_input_callback_set(bleash->view_port, input_callback, bleash);
     gui_add_view_port(bleash->gui, bleash->view_port, GuiLayerFullscreen);
 
-    bleash->running = true;
-    bleash->should_exit = false;
-    bleash->processing = false;
+    atomic_store(&bleash->running, true);
+    atomic_store(&bleash->should_exit, false);
+    atomic_store(&bleash->processing, false);
 
     FURI_LOG_I(TAG, "Starting app main loop");
 
     bleash->update_timer =
         furi_timer_alloc(bleash_update_timer_callback, FuriTimerTypePeriodic, bleash);
     if(bleash->update_timer) {
-        furi_timer_start(bleash->update_timer, VIEW_UPDATE_INTERVAL);
+        furi_timer_start(bleash->update_timer, bleash_profile(bleash)->redraw_interval_ms);
     }
 
     bleash->thread =
@@ -691,29 +1957,73 @@ int32_t BLEASH(void* p) {
     }
 
     BleashEvent event;
-    uint32_t loop_count = 0;
-    while(bleash->running) {
-        loop_count++;
-        if(loop_count % 1000 == 0) {
-            FURI_LOG_D(TAG, "Main loop iteration %lu", loop_count);
-        }
-
-        FuriStatus status = furi_message_queue_get(bleash->event_queue, &event, 100);
+    while(atomic_load(&bleash->running)) {
+        FuriStatus status = furi_message_queue_get(bleash->event_queue, &event, FuriWaitForever);
         if(status == FuriStatusOk) {
             if(event.type == BleashEventTypeKey) {
                 FURI_LOG_D(TAG, "Processing key event");
                 if(event.input.key == InputKeyBack) {
                     FURI_LOG_I(TAG, "Back key in event queue - exiting");
                     break;
+                } else if(event.input.key == InputKeyRight) {
+                    BleashExportFormat format = event.input.type == InputTypeLong ?
+                                                    BleashExportFormatJsonLines :
+                                                    BleashExportFormatCsv;
+                    bleash_export_start(bleash, format);
+                } else if(event.input.key == InputKeyUp) {
+                    furi_mutex_acquire(bleash->mutex, FuriWaitForever);
+                    log_energy_summary(bleash);
+                    log_sched_summary(bleash);
+                    bleash->power_profile = (bleash->power_profile + 1) % BleashPowerProfileCount;
+                    bleash_energy_reset(bleash);
+                    bleash_sched_reset(bleash);
+                    save_state(bleash);
+                    furi_mutex_release(bleash->mutex);
+
+                    FURI_LOG_I(TAG, "Power profile: %s", bleash_profile(bleash)->name);
+                    if(bleash->update_timer) {
+                        furi_timer_start(
+                            bleash->update_timer, bleash_profile(bleash)->redraw_interval_ms);
+                    }
+                    view_port_update(bleash->view_port);
+                } else if(event.input.key == InputKeyLeft) {
+                    furi_mutex_acquire(bleash->mutex, FuriWaitForever);
+                    bleash_observer_stop(bleash);
+                    bleash->leash_mode = (bleash->leash_mode + 1) % BleashLeashModeCount;
+                    bleash->last_rssi = -127;
+                    save_state(bleash);
+                    furi_mutex_release(bleash->mutex);
+
+                    FURI_LOG_I(TAG, "Leash mode: %d", bleash->leash_mode);
+                    view_port_update(bleash->view_port);
+                } else if(event.input.key == InputKeyDown) {
+                    furi_mutex_acquire(bleash->mutex, FuriWaitForever);
+                    if(bleash->calibration.active) {
+                        bleash->calibration.active = false;
+                        FURI_LOG_I(TAG, "Calibration cancelled");
+                    } else {
+                        bleash_calibration_start(bleash);
+                        // Samples only come from the monitoring worker
+                        if(!bleash->background_running) {
+                            bleash->background_running = true;
+                            save_state(bleash);
+                        }
+                    }
+                    furi_mutex_release(bleash->mutex);
+                    view_port_update(bleash->view_port);
                 }
             } else if(event.type == BleashEventTypeTick) {
-                if(bleash->view_port) {
+                // Only redraw when a pixel would change, frames cost CPU and display time
+                BleashViewModel model;
+                bleash_view_model(bleash, &model);
+                if(bleash->view_port &&
+                   !bleash_view_model_equal(&model, &bleash->view_model_drawn)) {
+                    bleash->view_model_drawn = model;
                     view_port_update(bleash->view_port);
                 }
+            } else if(event.type == BleashEventTypeExit) {
+                FURI_LOG_D(TAG, "Exit event received");
             }
-        } else if(status == FuriStatusErrorTimeout) {
-            // Timeout is normal, continue
-            continue;
         } else {
             FURI_LOG_W(TAG, "Message queue error: %d", status);
             break;
@@ -722,11 +2032,11 @@ int32_t BLEASH(void* p) {
 
     FURI_LOG_I(TAG, "Main loop exited, starting cleanup");
 
-    // STEP 1: Disable all callbacks FIRST to prevent race conditions
-    if(bleash->bt) {
-        bt_set_status_changed_callback(bleash->bt, NULL, NULL);
-        FURI_LOG_D(TAG, "BT callback disabled");
-    }
+    // STEP 1: Block new GUI/timer callbacks, in-flight ones are drained below
+    atomic_store(&bleash->processing, true);
+
+    // An export in progress notices running == false and removes its partial file
+    bleash_export_stop(bleash);
 
     // STEP 2: Stop timer to prevent further callbacks
     if(bleash->update_timer) {
@@ -736,37 +2046,47 @@ int32_t BLEASH(void* p) {
         FURI_LOG_D(TAG, "Timer stopped and freed");
     }
 
-    // STEP 3: Set processing flag to prevent worker thread from doing more work
-    if(furi_mutex_acquire(bleash->mutex, 1000) == FuriStatusOk) {
-        bleash->processing = true;
-        furi_mutex_release(bleash->mutex);
-        FURI_LOG_D(TAG, "Processing flag set");
+    // STEP 3: Detach the view port, GUI guarantees no draw/input calls afterwards
+    if(bleash->view_port) {
+        view_port_draw_callback_set(bleash->view_port, NULL, NULL);
+        view_port_input_callback_set(bleash->view_port, NULL, NULL);
+        if(bleash->gui) {
+            gui_remove_view_port(bleash->gui, bleash->view_port);
+        }
+        FURI_LOG_D(TAG, "View port removed from GUI");
     }
 
-    // STEP 4: Give time for any pending callbacks to complete
-    furi_delay_ms(150);
-
-    if(bleash->should_exit) {
+    if(atomic_load(&bleash->should_exit)) {
         FURI_LOG_I(TAG, "Fully exiting app");
 
-        // Stop worker thread before any GUI cleanup
+        // Unhook BT so no new status callbacks can start
+        uint32_t bt_unhook_tick = furi_get_tick();
+        if(bleash->bt) {
+            bt_set_status_changed_callback(bleash->bt, NULL, NULL);
+            FURI_LOG_D(TAG, "BT callback disabled");
+        }
+
+        // Worker was already signalled by the input callback, wake it again in case
+        // exit came from somewhere else
         if(bleash->thread) {
             FURI_LOG_I(TAG, "Stopping worker thread");
+            bleash_worker_signal_exit(bleash);
             furi_thread_join(bleash->thread);
             furi_thread_free(bleash->thread);
             bleash->thread = NULL;
         }
 
-        // Disable view port callbacks before freeing resources
-        if(bleash->view_port) {
-            view_port_draw_callback_set(bleash->view_port, NULL, NULL);
-            view_port_input_callback_set(bleash->view_port, NULL, NULL);
+        // The BT service may have read the old callback before the unhook without having
+        // entered it yet, which the callback counter cannot see. Such a dispatch gets a
+        // bounded grace period, usually already spent joining the worker.
+        uint32_t bt_grace_ticks = furi_ms_to_ticks(BT_UNHOOK_GRACE_MS);
+        uint32_t bt_unhooked_ticks = furi_get_tick() - bt_unhook_tick;
+        if(bt_unhooked_ticks < bt_grace_ticks) {
+            furi_delay_tick(bt_grace_ticks - bt_unhooked_ticks);
         }
 
-        // Now safe to clean up GUI
-        if(bleash->gui && bleash->view_port) {
-            gui_remove_view_port(bleash->gui, bleash->view_port);
-        }
+        // Wait for any callback that was already running when we unhooked it
+        bleash_drain_callbacks(bleash);
 
         if(bleash->view_port) {
             view_port_free(bleash->view_port);
@@ -783,9 +2103,25 @@ int32_t BLEASH(void* p) {
             bleash->gui = NULL;
         }
 
+        bleash_rollup_flush(bleash);
+
         // Remove instance file
         remove_instance_file(bleash);
 
+        // Record how long the long-press exit took, up to here. Only the single append
+        // of the exit records below is not part of it.
+        uint32_t exit_latency_ms = (furi_get_tick() - bleash->exit_request_tick) * 1000 /
+                                   furi_kernel_get_tick_frequency();
+        FURI_LOG_I(TAG, "Exit latency: %lu ms", exit_latency_ms);
+        char* batch = malloc(LOG_BATCH_SIZE);
+        bleash->log_batch = batch;
+        log_exit_latency(bleash, exit_latency_ms);
+        log_energy_summary(bleash);
+        log_sched_summary(bleash);
+        log_batch_flush(bleash);
+        bleash->log_batch = NULL;
+        free(batch);
+
         // Clean up BT service
         if(bleash->bt) {
             furi_record_close(RECORD_BT);
@@ -813,49 +2149,30 @@ int32_t BLEASH(void* p) {
     } else {
         FURI_LOG_I(TAG, "Hiding GUI, keeping worker running in background");
 
-        // STEP 1: Disable view port callbacks before freeing resources
-        if(bleash->view_port) {
-            view_port_draw_callback_set(bleash->view_port, NULL, NULL);
-            view_port_input_callback_set(bleash->view_port, NULL, NULL);
-            FURI_LOG_D(TAG, "View port callbacks disabled");
-        }
+        // STEP 4: Wait for in-flight GUI/timer callbacks, BT callback stays attached
+        // for the worker and is not blocked by the processing flag
+        bleash_drain_callbacks(bleash);
 
-        // STEP 2: Remove from GUI before freeing
-        if(bleash->gui && bleash->view_port) {
-            gui_remove_view_port(bleash->gui, bleash->view_port);
-            FURI_LOG_D(TAG, "View port removed from GUI");
-        }
-
-        // STEP 3: Now safe to free view port
+        // STEP 5: Now safe to free view port
         if(bleash->view_port) {
             view_port_free(bleash->view_port);
             bleash->view_port = NULL;
             FURI_LOG_D(TAG, "View port freed");
         }
 
-        // STEP 4: Free event queue (no longer needed without GUI)
+        // STEP 6: Free event queue (no longer needed without GUI)
         if(bleash->event_queue) {
             furi_message_queue_free(bleash->event_queue);
             bleash->event_queue = NULL;
             FURI_LOG_D(TAG, "Event queue freed");
         }
 
-        // STEP 5: Close GUI record
+        // STEP 7: Close GUI record
         if(bleash->gui) {
             furi_record_close(RECORD_GUI);
             bleash->gui = NULL;
             FURI_LOG_D(TAG, "GUI record closed");
         }
-
-        // STEP 6: Give time for any pending operations to complete
-        furi_delay_ms(100);
-
-        // STEP 7: Reset processing flag so worker can continue
-        if(bleash->mutex && furi_mutex_acquire(bleash->mutex, 1000) == FuriStatusOk) {
-            bleash->processing = false;
-            furi_mutex_release(bleash->mutex);
-            FURI_LOG_D(TAG, "Processing flag reset for background operation");
-        }
     }
 
     return 0;
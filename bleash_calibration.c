@@ -0,0 +1,29 @@
+#include "bleash_calibration.h"
+
+#include <string.h>
+
+void bleash_rssi_histogram_reset(BleashRssiHistogram* histogram) {
+    memset(histogram, 0, sizeof(BleashRssiHistogram));
+}
+
+void bleash_rssi_histogram_add(BleashRssiHistogram* histogram, int8_t rssi) {
+    // int8 replay data and the "no signal" sentinel can both fall outside the range
+    int32_t bin = (int32_t)rssi - BLEASH_RSSI_HISTOGRAM_MIN;
+    if(bin < 0) bin = 0;
+    if(bin >= BLEASH_RSSI_HISTOGRAM_BINS) bin = BLEASH_RSSI_HISTOGRAM_BINS - 1;
+
+    if(histogram->bins[bin] < UINT16_MAX) histogram->bins[bin]++;
+    histogram->samples++;
+}
+
+int8_t bleash_rssi_histogram_percentile(const BleashRssiHistogram* histogram, uint32_t percent) {
+    uint32_t target = ((uint64_t)histogram->samples * percent + 99) / 100;
+    if(target == 0) target = 1;
+    uint32_t seen = 0;
+    for(int32_t bin = 0; bin < BLEASH_RSSI_HISTOGRAM_BINS; bin++) {
+        seen += histogram->bins[bin];
+        if(seen >= target) return (int8_t)(bin + BLEASH_RSSI_HISTOGRAM_MIN);
+    }
+    // Only reachable once bins saturated, the rest is in the strongest bin
+    return (int8_t)(BLEASH_RSSI_HISTOGRAM_BINS - 1 + BLEASH_RSSI_HISTOGRAM_MIN);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// RSSI distribution for threshold calibration: one bin per dBm from -127 to 0, so
+// memory and per-sample work stay constant whatever the window length. No furi
+// dependencies, so it can be checked on the host.
+
+#define BLEASH_RSSI_HISTOGRAM_BINS 128
+#define BLEASH_RSSI_HISTOGRAM_MIN  -127 // Bin 0, weaker readings land here too
+
+typedef struct {
+    uint32_t samples;
+    uint16_t bins[BLEASH_RSSI_HISTOGRAM_BINS]; // Saturating counters
+} BleashRssiHistogram;
+
+void bleash_rssi_histogram_reset(BleashRssiHistogram* histogram);
+
+// Readings outside -127..0 dBm are clamped into the end bins
+void bleash_rssi_histogram_add(BleashRssiHistogram* histogram, int8_t rssi);
+
+// Weakest RSSI such that at least percent of the samples are at or below it
+int8_t bleash_rssi_histogram_percentile(const BleashRssiHistogram* histogram, uint32_t percent);
@@ -0,0 +1,99 @@
+#include "bleash_observer.h"
+
+#include <string.h>
+
+#define BLEASH_OBSERVER_TABLE_MASK (BLEASH_OBSERVER_TABLE_SIZE - 1)
+
+static uint64_t bleash_observer_key(const uint8_t* addr) {
+    uint64_t key = 0;
+    for(size_t i = 0; i < BLEASH_OBSERVER_ADDR_LEN; i++) {
+        key |= (uint64_t)addr[i] << (i * 8);
+    }
+    return key;
+}
+
+// Fibonacci hashing on 32 bits, cheap on Cortex-M4. Folding the top 16 bits in
+// keeps the OUI from dominating for public addresses.
+static uint32_t bleash_observer_hash(uint64_t key) {
+    uint32_t folded = (uint32_t)key ^ (uint32_t)(key >> 16);
+    return (folded * 0x9E3779B1U) >> 26; // 64 slots
+}
+
+_Static_assert(
+    BLEASH_OBSERVER_TABLE_SIZE == 64,
+    "bleash_observer_hash shift assumes a 64 slot table");
+_Static_assert(
+    BLEASH_OBSERVER_TABLE_SIZE >= 4 * BLEASH_OBSERVER_MAX_TARGETS,
+    "Watch list table must stay sparse for short probes");
+
+void bleash_observer_init(BleashObserver* observer) {
+    memset(observer, 0, sizeof(BleashObserver));
+}
+
+bool bleash_observer_add_target(BleashObserver* observer, const uint8_t* addr) {
+    if(observer->count >= BLEASH_OBSERVER_MAX_TARGETS) return false;
+
+    uint64_t key = bleash_observer_key(addr);
+    uint32_t slot = bleash_observer_hash(key);
+    while(observer->slots[slot]) {
+        if(observer->targets[observer->slots[slot] - 1].key == key) return false;
+        slot = (slot + 1) & BLEASH_OBSERVER_TABLE_MASK;
+    }
+
+    BleashObserverTarget* target = &observer->targets[observer->count];
+    memset(target, 0, sizeof(BleashObserverTarget));
+    target->key = key;
+    observer->slots[slot] = ++observer->count;
+    return true;
+}
+
+BleashObserverTarget* bleash_observer_ingest(
+    BleashObserver* observer,
+    const uint8_t* addr,
+    int8_t rssi,
+    uint32_t now_ms) {
+    observer->reports_total++;
+
+    // Most reports in a busy place are strangers: with a sparse table the probe
+    // usually ends on the first, empty, slot
+    uint64_t key = bleash_observer_key(addr);
+    uint32_t slot = bleash_observer_hash(key);
+    while(observer->slots[slot]) {
+        BleashObserverTarget* target = &observer->targets[observer->slots[slot] - 1];
+        if(target->key == key) {
+            if(target->seen) {
+                // EWMA with alpha 1/4
+                target->rssi_q4 += (rssi * 16 - target->rssi_q4) / 4;
+            } else {
+                target->rssi_q4 = rssi * 16;
+                target->seen = true;
+            }
+            target->last_seen_ms = now_ms;
+            target->reports++;
+            observer->reports_matched++;
+            return target;
+        }
+        slot = (slot + 1) & BLEASH_OBSERVER_TABLE_MASK;
+    }
+    return NULL;
+}
+
+static int bleash_observer_hex(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool bleash_observer_parse_addr(const char* str, uint8_t* addr) {
+    for(size_t i = 0; i < BLEASH_OBSERVER_ADDR_LEN; i++) {
+        const char* byte = &str[i * 3];
+        int high = bleash_observer_hex(byte[0]);
+        int low = high < 0 ? -1 : bleash_observer_hex(byte[1]);
+        if(low < 0) return false;
+        if(i < BLEASH_OBSERVER_ADDR_LEN - 1 && byte[2] != ':') return false;
+        // Over the air the least significant byte comes first
+        addr[BLEASH_OBSERVER_ADDR_LEN - 1 - i] = (uint8_t)((high << 4) | low);
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Passive leash: advertising reports are matched against a small watch list and
+// each target keeps its last-seen time and a filtered RSSI. No furi dependencies,
+// so the filter can be built and benchmarked on the host.
+
+#define BLEASH_OBSERVER_MAX_TARGETS 16
+#define BLEASH_OBSERVER_TABLE_SIZE  64 // Power of two, keeps load factor <= 1/4
+#define BLEASH_OBSERVER_ADDR_LEN    6
+
+// One captured advertising report, also the on-disk replay record (little endian)
+typedef struct {
+    uint32_t time_ms;
+    uint8_t addr[BLEASH_OBSERVER_ADDR_LEN];
+    int8_t rssi;
+    uint8_t flags;
+} BleashAdvReport;
+
+_Static_assert(sizeof(BleashAdvReport) == 12, "Report layout is the replay file format");
+
+typedef struct {
+    uint64_t key; // 48-bit address packed into an integer for one-compare matches
+    uint32_t last_seen_ms;
+    uint32_t reports;
+    int16_t rssi_q4; // Exponentially filtered RSSI in 1/16 dBm
+    bool seen;
+} BleashObserverTarget;
+
+typedef struct {
+    BleashObserverTarget targets[BLEASH_OBSERVER_MAX_TARGETS];
+    uint8_t slots[BLEASH_OBSERVER_TABLE_SIZE]; // 0 = empty, else target index + 1
+    uint8_t count;
+    uint32_t reports_total;
+    uint32_t reports_matched;
+} BleashObserver;
+
+void bleash_observer_init(BleashObserver* observer);
+
+// Returns false when the watch list is full or the address is already watched
+bool bleash_observer_add_target(BleashObserver* observer, const uint8_t* addr);
+
+// Hot path, O(1) expected. Returns the matched target or NULL.
+BleashObserverTarget* bleash_observer_ingest(
+    BleashObserver* observer,
+    const uint8_t* addr,
+    int8_t rssi,
+    uint32_t now_ms);
+
+static inline int8_t bleash_observer_target_rssi(const BleashObserverTarget* target) {
+    return (int8_t)(target->rssi_q4 / 16);
+}
+
+// A target is lost once it was not seen for timeout_ms (or never seen at all)
+static inline bool bleash_observer_target_lost(
+    const BleashObserverTarget* target,
+    uint32_t now_ms,
+    uint32_t timeout_ms) {
+    return !target->seen || (now_ms - target->last_seen_ms) > timeout_ms;
+}
+
+// Parses "AA:BB:CC:DD:EE:FF" (most significant byte first, as shown by phones)
+bool bleash_observer_parse_addr(const char* str, uint8_t* addr);
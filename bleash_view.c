@@ -0,0 +1,109 @@
+#include "bleash_view.h"
+
+#include <stdio.h>
+
+// Indexed by BtStatus
+static const char* const bleash_view_status_names[] = {
+    "Unavailable",
+    "BT Off",
+    "Advertising",
+    "Connected",
+};
+
+#define BLEASH_VIEW_STATUS_COUNT (sizeof(bleash_view_status_names) / sizeof(char*))
+
+void bleash_view_cache_init(BleashViewCache* cache) {
+    memset(cache, 0, sizeof(BleashViewCache));
+}
+
+// Title, divider and control hints, the same on every frame
+static void bleash_view_draw_static(Canvas* canvas, const char* title) {
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, title);
+    canvas_draw_line(canvas, 0, 11, 128, 11);
+    canvas_draw_str(canvas, 2, 55, "OK: Toggle");
+    canvas_draw_str_aligned(canvas, 126, 55, AlignRight, AlignBottom, "Back: Hide");
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "Long Back: Exit");
+}
+
+static const char* bleash_view_status_str(BleashViewCache* cache, const BleashViewModel* model) {
+    if(!model->observer) {
+        if(model->status >= BLEASH_VIEW_STATUS_COUNT) return "Unknown";
+        return bleash_view_status_names[model->status];
+    }
+    if(model->watchlist_empty) return "No watch list";
+
+    if(!cache->observer_valid || cache->present != model->present ||
+       cache->targets != model->targets) {
+        snprintf(
+            cache->observer_str,
+            sizeof(cache->observer_str),
+            "Seen %u/%u",
+            model->present,
+            model->targets);
+        cache->present = model->present;
+        cache->targets = model->targets;
+        cache->observer_valid = true;
+    }
+    return cache->observer_str;
+}
+
+static void bleash_view_draw_signal(Canvas* canvas, BleashViewCache* cache, int8_t rssi) {
+    if(!cache->rssi_valid || cache->rssi != rssi) {
+        snprintf(cache->rssi_str, sizeof(cache->rssi_str), "Signal: %d dBm", rssi);
+        cache->rssi = rssi;
+        cache->rssi_valid = true;
+    }
+    canvas_draw_str(canvas, 2, 36, cache->rssi_str);
+
+    uint8_t bars = ((rssi + 130) / 10);
+    if(bars > 5) bars = 5;
+
+    canvas_draw_frame(canvas, 90, 29, 15, 8);
+    canvas_draw_box(canvas, 105, 31, 2, 4);
+
+    for(uint8_t i = 0; i < bars; i++) {
+        canvas_draw_box(canvas, 92 + (i * 3), 31, 2, 4);
+    }
+}
+
+void bleash_view_draw(Canvas* canvas, BleashViewCache* cache, const BleashViewModel* model) {
+    // The GUI resets the canvas before every draw callback, no clear needed
+    bleash_view_draw_static(canvas, model->title);
+
+    canvas_draw_str(canvas, 2, 24, bleash_view_status_str(cache, model));
+
+    if(!cache->profile_valid || cache->profile_name != model->profile_name ||
+       cache->cost_ua != model->cost_ua) {
+        snprintf(
+            cache->profile_str,
+            sizeof(cache->profile_str),
+            "%s %lu.%02lumAh/h",
+            model->profile_name,
+            (unsigned long)(model->cost_ua / 1000),
+            (unsigned long)((model->cost_ua % 1000) / 10));
+        cache->profile_name = model->profile_name;
+        cache->cost_ua = model->cost_ua;
+        cache->profile_valid = true;
+    }
+    canvas_draw_str_aligned(canvas, 126, 24, AlignRight, AlignBottom, cache->profile_str);
+
+    if(model->show_signal) {
+        bleash_view_draw_signal(canvas, cache, model->rssi);
+    }
+
+    canvas_set_font(canvas, FontPrimary);
+    const char* state_str = model->running ? "Monitoring ON" : "Monitoring OFF";
+    if(model->calibration_left_s) {
+        if(cache->calibration_left_s != model->calibration_left_s) {
+            snprintf(
+                cache->calibration_str,
+                sizeof(cache->calibration_str),
+                "Calibrating %us",
+                model->calibration_left_s);
+            cache->calibration_left_s = model->calibration_left_s;
+        }
+        state_str = cache->calibration_str;
+    }
+    canvas_draw_str_aligned(canvas, 64, 42, AlignCenter, AlignCenter, state_str);
+}
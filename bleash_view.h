@@ -0,0 +1,53 @@
+#pragma once
+
+#include <gui/canvas.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Status screen. Overlay strings are only formatted when their value changes and
+// callers skip redraws whose model matches the last frame. Depends on the canvas
+// API alone, so it can be benchmarked on the host against a stub canvas.
+
+// Everything the screen shows. Build it zero-initialised: models are compared
+// with memcmp to skip redraws that would not change a pixel.
+typedef struct {
+    const char* title;
+    const char* profile_name;
+    uint32_t cost_ua;
+    uint16_t calibration_left_s; // 0 when not calibrating
+    uint8_t status; // BtStatus
+    uint8_t present; // Observer targets in range
+    uint8_t targets; // Observer watch list size
+    int8_t rssi;
+    bool observer;
+    bool watchlist_empty;
+    bool show_signal;
+    bool running;
+} BleashViewModel;
+
+// Overlay strings, owned by the GUI thread
+typedef struct {
+    bool rssi_valid;
+    int8_t rssi;
+    char rssi_str[20];
+    bool profile_valid;
+    const char* profile_name;
+    uint32_t cost_ua;
+    char profile_str[24];
+    bool observer_valid;
+    uint8_t present;
+    uint8_t targets;
+    char observer_str[16];
+    uint16_t calibration_left_s;
+    char calibration_str[20];
+} BleashViewCache;
+
+void bleash_view_cache_init(BleashViewCache* cache);
+
+void bleash_view_draw(Canvas* canvas, BleashViewCache* cache, const BleashViewModel* model);
+
+static inline bool
+    bleash_view_model_equal(const BleashViewModel* a, const BleashViewModel* b) {
+    return memcmp(a, b, sizeof(BleashViewModel)) == 0;
+}
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Summarise a Bleash session export (CSV or JSON lines).
+
+Streams the file once and keeps constant memory: RSSI percentiles come from a
+histogram keyed by dBm and disconnect durations from fixed buckets, so months of
+per-second samples are processed in seconds.
+
+Each row carries the logging period of the profile it was taken under, so a gap
+is only treated as the app not running once it exceeds twice that period (or
+--max-gap, whichever is longer). Exports from before the period column use
+--max-gap alone.
+
+Usage: bleash_analyze.py [--max-gap SECONDS] bleash_<epoch>.csv|.jsonl
+"""
+
+import argparse
+import operator
+import re
+import sys
+from collections import Counter
+from itertools import compress, repeat
+
+# BtStatus values written by the app, then the observer mode codes
+STATUS_NAMES = {
+    0: "Unavailable",
+    1: "Off",
+    2: "Advertising",
+    3: "Connected",
+    4: "All seen",
+    5: "Target lost",
+}
+# The leash is intact: connected, or every watched target seen in observer mode
+STATUS_INTACT = (3, 4)
+
+ALERT_WEAK_SIGNAL = 1
+ALERT_DISCONNECT = 2
+
+# Columns other than the timestamp are kept as the raw tokens from the file
+TOKENS_INTACT = frozenset(str(status).encode() for status in STATUS_INTACT)
+TOKEN_DISCONNECT = str(ALERT_DISCONNECT).encode()
+
+RSSI_PERCENTILES = (5, 25, 50, 75, 95)
+
+# Upper bounds (seconds) of the disconnect duration buckets
+DURATION_BUCKETS = (5, 30, 60, 300, 1800, 3600)
+
+
+# Exports are parsed a block at a time and every per-row operation below is a
+# builtin (map/compress/Counter), so the Python interpreter only runs per block
+CHUNK_SIZE = 1 << 22
+NUMBER = re.compile(rb"-?[0-9]+")
+
+
+def block_columns(block, jsonl, width):
+    # Both formats carry the same integers per row in a fixed order, and the JSON
+    # keys contain no digits, so rows are just consecutive runs of numbers
+    if jsonl:
+        values = NUMBER.findall(block)
+    else:
+        values = block.replace(b",", b" ").split()
+    # Only timestamps and periods need arithmetic, the other columns are counted as
+    # raw tokens
+    times = list(map(int, values[0::width]))
+    if width > 4:
+        periods = list(map(int, values[4::width]))
+    else:
+        periods = [0] * len(times)
+    return times, values[1::width], values[2::width], values[3::width], periods
+
+
+def iter_blocks(export, jsonl, width):
+    carry = b""
+    while True:
+        block = export.read(CHUNK_SIZE)
+        if not block:
+            break
+        block = carry + block
+        cut = block.rfind(b"\n") + 1
+        carry = block[cut:]
+        if cut:
+            yield block_columns(block[:cut], jsonl, width)
+    if carry.strip():
+        yield block_columns(carry, jsonl, width)
+
+
+def format_duration(seconds):
+    hours, rest = divmod(int(seconds), 3600)
+    minutes, seconds = divmod(rest, 60)
+    return f"{hours}h{minutes:02d}m{seconds:02d}s"
+
+
+class SessionStats:
+    def __init__(self, max_gap):
+        self.max_gap = max_gap
+        self.samples = 0
+        self.first = None
+        self.last = None
+        self.last_status = None
+        self.last_period = 0
+        self.status_seconds = Counter()
+        self.rssi_histogram = Counter()
+        self.rssi_samples = 0
+        self.alerts = Counter()
+        self.disconnected_at = None
+        self.duration_buckets = [0] * (len(DURATION_BUCKETS) + 1)
+        self.duration_total = 0
+        self.duration_min = None
+        self.duration_max = 0
+        self.durations = 0
+
+    def consume(self, times, statuses, rssis, alerts, periods):
+        """Fold one block of columns into the stats."""
+        if not times:
+            return
+
+        # Prepend the last sample of the previous block so intervals span blocks
+        if self.last is not None:
+            times = [self.last] + times
+            statuses = [self.last_status] + statuses
+            periods = [self.last_period] + periods
+        elif self.first is None:
+            self.first = times[0]
+
+        # Interval i runs from sample i to i + 1 and belongs to status i. Gaps
+        # outside (0, limit] mean the app was not running and are taken back out,
+        # the limit follows the logging period sample i was taken under.
+        gaps = list(map(operator.sub, times[1:], times[:-1]))
+        limits = map(max, repeat(self.max_gap), map((2).__mul__, periods))
+        for code in set(statuses):
+            self.status_seconds[code] += sum(compress(gaps, map(code.__eq__, statuses)))
+        for outside in (map(operator.gt, gaps, limits), map((1).__gt__, gaps)):
+            for gap, status in compress(zip(gaps, statuses), outside):
+                self.status_seconds[status] -= gap
+        if self.last is not None:
+            times = times[1:]
+            statuses = statuses[1:]
+            periods = periods[1:]
+
+        self.samples += len(times)
+        self.last = times[-1]
+        self.last_status = statuses[-1]
+        self.last_period = periods[-1]
+
+        connected = list(map(TOKENS_INTACT.__contains__, statuses))
+        self.rssi_histogram.update(compress(rssis, connected))
+        self.rssi_samples += sum(connected)
+        self.alerts.update(alerts)
+
+        # Disconnects are rare, walk only those and find the reconnect with a
+        # C-level list search
+        disconnects = compress(range(len(alerts)), map(TOKEN_DISCONNECT.__eq__, alerts))
+        start = 0
+        for index in disconnects:
+            self.close_disconnect(times, connected, start)
+            self.disconnected_at = times[index]
+            # A drop that reconnected before the sample closes on its own row
+            start = index if connected[index] else index + 1
+        self.close_disconnect(times, connected, start)
+
+    def close_disconnect(self, times, connected, start):
+        if self.disconnected_at is None:
+            return
+        try:
+            index = connected.index(True, start)
+        except ValueError:
+            return
+        self.add_disconnect_duration(times[index] - self.disconnected_at)
+        self.disconnected_at = None
+
+    def add_disconnect_duration(self, duration):
+        for i, bound in enumerate(DURATION_BUCKETS):
+            if duration < bound:
+                self.duration_buckets[i] += 1
+                break
+        else:
+            self.duration_buckets[-1] += 1
+        self.durations += 1
+        self.duration_total += duration
+        self.duration_max = max(self.duration_max, duration)
+        if self.duration_min is None or duration < self.duration_min:
+            self.duration_min = duration
+
+    def rssi_percentile(self, percentile):
+        target = self.rssi_samples * percentile / 100
+        seen = 0
+        for rssi in sorted(self.rssi_histogram, key=int):
+            seen += self.rssi_histogram[rssi]
+            if seen >= target:
+                return int(rssi)
+        return None
+
+    def report(self, out):
+        if not self.samples:
+            out.write("No samples\n")
+            return
+
+        status_seconds = Counter()
+        for code, seconds in self.status_seconds.items():
+            status_seconds[int(code)] += seconds
+        alerts = Counter()
+        for code, count in self.alerts.items():
+            alerts[int(code)] += count
+
+        out.write(f"Samples:          {self.samples}\n")
+        out.write(f"Span:             {format_duration(self.last - self.first)}\n")
+        for code, name in STATUS_NAMES.items():
+            out.write(f"Time {name + ':':<13}{format_duration(status_seconds[code])}\n")
+
+        out.write(f"Disconnects:      {alerts[ALERT_DISCONNECT]}\n")
+        if self.durations:
+            out.write(
+                f"  duration min/mean/max: {self.duration_min}s / "
+                f"{self.duration_total / self.durations:.1f}s / {self.duration_max}s\n"
+            )
+            lower = 0
+            for bound, count in zip(DURATION_BUCKETS + (None,), self.duration_buckets):
+                label = f"{lower}-{bound}s" if bound else f">={lower}s"
+                out.write(f"  {label:<12}{count}\n")
+                lower = bound
+        if self.disconnected_at is not None:
+            out.write("  (still disconnected at end of export)\n")
+
+        out.write(f"Weak signal:      {alerts[ALERT_WEAK_SIGNAL]}\n")
+        if self.rssi_samples:
+            percentiles = ", ".join(
+                f"p{p}={self.rssi_percentile(p)}" for p in RSSI_PERCENTILES
+            )
+            out.write(f"RSSI (intact):    {percentiles} dBm\n")
+
+
+def analyze(path, max_gap):
+    stats = SessionStats(max_gap)
+    with open(path, "rb") as export:
+        first_line = export.peek(256).split(b"\n", 1)[0]
+        jsonl = first_line[:1] == b"{"
+        # Older exports have fewer columns, count them on the header or first row
+        width = len(NUMBER.findall(first_line)) if jsonl else len(first_line.split(b","))
+        if not jsonl:
+            # Skip the CSV header line
+            export.readline()
+        for columns in iter_blocks(export, jsonl, width):
+            stats.consume(*columns)
+    return stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("export", help="CSV or JSON lines file from /ext/Bleash/export")
+    parser.add_argument(
+        "--max-gap",
+        type=int,
+        default=60,
+        help="shortest gap in seconds treated as the app not running, raised to twice "
+        "the logging period of each row (default 60)",
+    )
+    args = parser.parse_args()
+
+    analyze(args.export, args.max_gap).report(sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Print the hourly/daily rollups written by Bleash to /ext/Bleash/rollup.bin.
+
+Records are additive: an hour or day interrupted by an app restart appears more
+than once with the same start and is summed here.
+
+Usage: bleash_rollup.py [--hourly] [--days N] rollup.bin
+"""
+
+import argparse
+import struct
+import sys
+import time
+from collections import OrderedDict
+
+# BleashRollupRecord, little endian, 40 bytes
+RECORD = struct.Struct("<I4IIIiHBBbb2x")
+
+KIND_HOUR = 0
+KIND_DAY = 1
+
+STATUS_CONNECTED = 3
+
+
+def format_duration(seconds):
+    hours, rest = divmod(int(seconds), 3600)
+    minutes, seconds = divmod(rest, 60)
+    return f"{hours}h{minutes:02d}m{seconds:02d}s"
+
+
+def read_rollups(path, kind):
+    periods = OrderedDict()
+    with open(path, "rb") as rollup:
+        data = rollup.read()
+    usable = len(data) - len(data) % RECORD.size
+    for fields in RECORD.iter_unpack(data[:usable]):
+        start, *status, below, samples, rssi_sum, disconnects, record_kind, _, rssi_min, rssi_max = fields
+        if record_kind != kind:
+            continue
+        period = periods.setdefault(
+            start,
+            {"status": [0] * 4, "below": 0, "samples": 0, "rssi_sum": 0, "disconnects": 0,
+             "rssi_min": None, "rssi_max": None},
+        )
+        period["status"] = [a + b for a, b in zip(period["status"], status)]
+        period["below"] += below
+        period["disconnects"] += disconnects
+        if samples:
+            period["samples"] += samples
+            period["rssi_sum"] += rssi_sum
+            if period["rssi_min"] is None or rssi_min < period["rssi_min"]:
+                period["rssi_min"] = rssi_min
+            if period["rssi_max"] is None or rssi_max > period["rssi_max"]:
+                period["rssi_max"] = rssi_max
+    return periods
+
+
+def report(periods, hourly, days, out):
+    starts = sorted(periods)
+    if days and starts:
+        starts = [s for s in starts if s > starts[-1] - days * 86400]
+    if not starts:
+        out.write("No rollups\n")
+        return
+
+    stamp = "%Y-%m-%d %H:00" if hourly else "%Y-%m-%d"
+    out.write(f"{'period':<17}{'connected':>11}{'other':>11}{'weak':>11}{'disc':>6}  rssi min/mean/max\n")
+    for start in starts:
+        period = periods[start]
+        connected = period["status"][STATUS_CONNECTED]
+        other = sum(period["status"]) - connected
+        rssi = "-"
+        if period["samples"]:
+            mean = period["rssi_sum"] / period["samples"]
+            rssi = f"{period['rssi_min']}/{mean:.1f}/{period['rssi_max']}"
+        out.write(
+            f"{time.strftime(stamp, time.gmtime(start)):<17}"
+            f"{format_duration(connected):>11}{format_duration(other):>11}"
+            f"{format_duration(period['below']):>11}{period['disconnects']:>6}  {rssi}\n"
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("rollup", help="rollup.bin copied from /ext/Bleash")
+    parser.add_argument("--hourly", action="store_true", help="show hours instead of days")
+    parser.add_argument("--days", type=int, default=0, help="only the last N days")
+    args = parser.parse_args()
+
+    periods = read_rollups(args.rollup, KIND_HOUR if args.hourly else KIND_DAY)
+    report(periods, args.hourly, args.days, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+// Host check for the calibration histogram and percentile.
+//
+// Feeds edge readings (int8 extremes, the -127 "no signal" sentinel) and known
+// distributions through bleash_calibration.c and compares bins and percentiles
+// with the expected values. Build it with the sanitizers to catch writes outside
+// the histogram.
+//
+//   cc -g -fsanitize=address -I. tools/calibration_check.c bleash_calibration.c
+//   ./a.out
+//
+// Excluded from the FAP build in application.fam.
+
+#include "bleash_calibration.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected)                                                        \
+    do {                                                                                  \
+        long a = (long)(actual);                                                          \
+        long e = (long)(expected);                                                        \
+        if(a != e) {                                                                      \
+            printf("%s:%d: %s = %ld, expected %ld\n", __FILE__, __LINE__, #actual, a, e); \
+            failures++;                                                                   \
+        }                                                                                 \
+    } while(0)
+
+// Heap allocated with nothing around it, so a stray bin write trips ASan
+static BleashRssiHistogram* histogram_new(void) {
+    BleashRssiHistogram* histogram = malloc(sizeof(BleashRssiHistogram));
+    bleash_rssi_histogram_reset(histogram);
+    return histogram;
+}
+
+static void check_clamping(void) {
+    BleashRssiHistogram* histogram = histogram_new();
+    bleash_rssi_histogram_add(histogram, INT8_MIN);
+    bleash_rssi_histogram_add(histogram, -127);
+    bleash_rssi_histogram_add(histogram, 0);
+    bleash_rssi_histogram_add(histogram, 1);
+    bleash_rssi_histogram_add(histogram, INT8_MAX);
+
+    CHECK_EQ(histogram->samples, 5);
+    CHECK_EQ(histogram->bins[0], 2);
+    CHECK_EQ(histogram->bins[BLEASH_RSSI_HISTOGRAM_BINS - 1], 3);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 0), -127);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 40), -127);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 41), 0);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 100), 0);
+    free(histogram);
+}
+
+static void check_empty(void) {
+    BleashRssiHistogram* histogram = histogram_new();
+    // Nothing to rank, falls through to the strongest bin
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 5), 0);
+    free(histogram);
+}
+
+static void check_uniform(void) {
+    // 100 samples, one per dBm from -100 to -1
+    BleashRssiHistogram* histogram = histogram_new();
+    for(int rssi = -100; rssi < 0; rssi++) {
+        bleash_rssi_histogram_add(histogram, (int8_t)rssi);
+    }
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 1), -100);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 5), -96);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 50), -51);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 100), -1);
+    free(histogram);
+}
+
+static void check_carried(void) {
+    // Two minutes at 500 ms: mostly around -60 with a short walk away to -85
+    BleashRssiHistogram* histogram = histogram_new();
+    for(int i = 0; i < 228; i++) {
+        bleash_rssi_histogram_add(histogram, (int8_t)(-58 - i % 5));
+    }
+    for(int i = 0; i < 12; i++) {
+        bleash_rssi_histogram_add(histogram, (int8_t)(-85 + i));
+    }
+    CHECK_EQ(histogram->samples, 240);
+    // Target is ceil(240 * 5 / 100) = 12 samples, exactly the walk
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 5), -74);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 50), -60);
+    free(histogram);
+}
+
+static void check_saturation(void) {
+    BleashRssiHistogram* histogram = histogram_new();
+    for(uint32_t i = 0; i < UINT16_MAX + 10U; i++) {
+        bleash_rssi_histogram_add(histogram, -70);
+    }
+    CHECK_EQ(histogram->bins[-70 - BLEASH_RSSI_HISTOGRAM_MIN], UINT16_MAX);
+    CHECK_EQ(histogram->samples, UINT16_MAX + 10U);
+    CHECK_EQ(bleash_rssi_histogram_percentile(histogram, 5), -70);
+    free(histogram);
+}
+
+int main(void) {
+    check_clamping();
+    check_empty();
+    check_uniform();
+    check_carried();
+    check_saturation();
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All calibration checks passed\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Host stand-in for the firmware canvas API, just what bleash_view.c uses. The
+// implementation lives in tools/view_bench.c.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct Canvas Canvas;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignRight,
+    AlignTop,
+    AlignBottom,
+    AlignCenter,
+} Align;
+
+void canvas_clear(Canvas* canvas);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str);
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str);
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height);
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height);
@@ -0,0 +1,179 @@
+// Host benchmark for the observer address filter.
+//
+// Replays a capture of BleashAdvReport records (the same format the app reads
+// from /ext/Bleash/adv_replay.bin) through bleash_observer_ingest, or generates
+// a synthetic busy-office stream when no capture is given.
+//
+//   cc -O2 -I. tools/observer_bench.c bleash_observer.c -o observer_bench
+//   ./observer_bench [capture.bin [watchlist.txt]]
+//   ./observer_bench --write capture.bin      write the synthetic stream
+//
+// Excluded from the FAP build in application.fam.
+
+#include "bleash_observer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SYNTHETIC_REPORTS   2000000
+#define SYNTHETIC_STRANGERS 500
+#define SYNTHETIC_TARGETS   8
+#define SYNTHETIC_RATE_HZ   400 // Reports per second in a busy office
+#define BENCH_ROUNDS        5
+
+static const char* target_addrs[SYNTHETIC_TARGETS] = {
+    "C0:FF:EE:00:00:01",
+    "C0:FF:EE:00:00:02",
+    "C0:FF:EE:00:00:03",
+    "C0:FF:EE:00:00:04",
+    "DE:AD:BE:EF:00:01",
+    "DE:AD:BE:EF:00:02",
+    "12:34:56:78:9A:BC",
+    "F0:0D:F0:0D:F0:0D",
+};
+
+static uint32_t xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static BleashAdvReport* synthesize(size_t* count) {
+    BleashAdvReport* reports = malloc(SYNTHETIC_REPORTS * sizeof(BleashAdvReport));
+    uint8_t strangers[SYNTHETIC_STRANGERS][BLEASH_OBSERVER_ADDR_LEN];
+    uint32_t seed = 0x12345678;
+
+    for(size_t i = 0; i < SYNTHETIC_STRANGERS; i++) {
+        for(size_t j = 0; j < BLEASH_OBSERVER_ADDR_LEN; j++) {
+            strangers[i][j] = (uint8_t)xorshift32(&seed);
+        }
+    }
+
+    for(size_t i = 0; i < SYNTHETIC_REPORTS; i++) {
+        BleashAdvReport* report = &reports[i];
+        report->time_ms = (uint32_t)(i * 1000 / SYNTHETIC_RATE_HZ);
+        report->rssi = (int8_t)(-40 - (int)(xorshift32(&seed) % 55));
+        report->flags = 0;
+        // About 1 in 20 reports comes from a watched tag
+        if(xorshift32(&seed) % 20 == 0) {
+            bleash_observer_parse_addr(
+                target_addrs[xorshift32(&seed) % SYNTHETIC_TARGETS], report->addr);
+        } else {
+            memcpy(
+                report->addr,
+                strangers[xorshift32(&seed) % SYNTHETIC_STRANGERS],
+                BLEASH_OBSERVER_ADDR_LEN);
+        }
+    }
+
+    *count = SYNTHETIC_REPORTS;
+    return reports;
+}
+
+static BleashAdvReport* load_capture(const char* path, size_t* count) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    *count = size / sizeof(BleashAdvReport);
+    if(!*count) {
+        fclose(file);
+        return NULL;
+    }
+    BleashAdvReport* reports = malloc(*count * sizeof(BleashAdvReport));
+    *count = fread(reports, sizeof(BleashAdvReport), *count, file);
+    fclose(file);
+    return reports;
+}
+
+// Same format as /ext/Bleash/watchlist.txt, one address per line
+static void load_watchlist(BleashObserver* observer, const char* path) {
+    char line[64];
+    uint8_t addr[BLEASH_OBSERVER_ADDR_LEN];
+
+    if(!path) {
+        for(size_t i = 0; i < SYNTHETIC_TARGETS; i++) {
+            bleash_observer_parse_addr(target_addrs[i], addr);
+            bleash_observer_add_target(observer, addr);
+        }
+        return;
+    }
+
+    FILE* file = fopen(path, "r");
+    while(file && fgets(line, sizeof(line), file)) {
+        if(bleash_observer_parse_addr(line, addr)) {
+            bleash_observer_add_target(observer, addr);
+        }
+    }
+    if(file) fclose(file);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    size_t count = 0;
+    BleashAdvReport* reports;
+
+    if(argc == 3 && strcmp(argv[1], "--write") == 0) {
+        reports = synthesize(&count);
+        FILE* file = fopen(argv[2], "wb");
+        if(!file || fwrite(reports, sizeof(BleashAdvReport), count, file) != count) {
+            fprintf(stderr, "Failed to write %s\n", argv[2]);
+            return 1;
+        }
+        fclose(file);
+        printf("Wrote %zu reports to %s\n", count, argv[2]);
+        return 0;
+    }
+
+    reports = argc >= 2 ? load_capture(argv[1], &count) : synthesize(&count);
+    if(!reports || !count) {
+        fprintf(stderr, "No reports to replay\n");
+        return 1;
+    }
+
+    BleashObserver observer;
+    double best = 0;
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+        bleash_observer_init(&observer);
+        load_watchlist(&observer, argc >= 3 ? argv[2] : NULL);
+
+        double start = now_seconds();
+        for(size_t i = 0; i < count; i++) {
+            bleash_observer_ingest(
+                &observer, reports[i].addr, reports[i].rssi, reports[i].time_ms);
+        }
+        double elapsed = now_seconds() - start;
+        if(round == 0 || elapsed < best) best = elapsed;
+    }
+
+    double span_s = (reports[count - 1].time_ms - reports[0].time_ms) / 1000.0;
+    printf("Reports:        %zu (%u matched)\n", count, observer.reports_matched);
+    printf(
+        "Capture span:   %.1f s (%.0f reports/s)\n", span_s, span_s > 0 ? count / span_s : 0);
+    printf(
+        "Ingest:         %.1f ns/report, %.1f M reports/s\n",
+        best * 1e9 / count,
+        count / best / 1e6);
+    for(size_t i = 0; i < observer.count; i++) {
+        const BleashObserverTarget* target = &observer.targets[i];
+        printf(
+            "  target %zu: %u reports, rssi %d dBm\n",
+            i,
+            target->reports,
+            bleash_observer_target_rssi(target));
+    }
+
+    free(reports);
+    return 0;
+}
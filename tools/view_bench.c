@@ -0,0 +1,336 @@
+// Host benchmark for the status view.
+//
+// Renders frames through bleash_view_draw and through the previous draw (kept
+// below as the baseline) on a stub canvas that follows u8g2's costs: glyphs are
+// looked up by walking the font table and drawn one run at a time. Per frame the
+// two differ only in string formatting; the saving is in the ticks whose model
+// did not change and are not drawn at all. Absolute times are the host's, the
+// primitive and pixel counts carry over to the Flipper.
+//
+//   cc -O2 -I. -Itools/host tools/view_bench.c bleash_view.c -o view_bench
+//   ./view_bench
+//
+// Excluded from the FAP build in application.fam.
+
+#include "bleash_view.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES 200000
+#define BENCH_ROUNDS 5
+#define SCREEN_W     128
+#define SCREEN_H     64
+#define GLYPH_W      5
+#define GLYPH_H      8
+
+// One session hour at the Balanced profile: a sample every 1 s, a tick every 500 ms
+#define SESSION_TICKS            7200
+#define SESSION_TICKS_PER_SAMPLE 2
+
+struct Canvas {
+    uint8_t fb[SCREEN_W * SCREEN_H / 8];
+    uint8_t font[96 * (GLYPH_H + 1)]; // Per glyph: a size byte, then one row mask per line
+    Font current_font;
+    uint32_t calls;
+    uint32_t glyphs;
+    uint32_t pixel_ops;
+};
+
+static volatile uint8_t glyph_sink; // Keeps lookups whose result is unused
+
+static void stub_pixel(Canvas* canvas, int32_t x, int32_t y) {
+    canvas->pixel_ops++;
+    if(x < 0 || y < 0 || x >= SCREEN_W || y >= SCREEN_H) return;
+    canvas->fb[(y / 8) * SCREEN_W + x] |= 1 << (y % 8);
+}
+
+static void stub_hline(Canvas* canvas, int32_t x, int32_t y, int32_t len) {
+    for(int32_t i = 0; i < len; i++) {
+        stub_pixel(canvas, x + i, y);
+    }
+}
+
+// u8g2 jumps to the first glyph of the 'A' or 'a' range, then walks glyph by glyph
+static const uint8_t* stub_glyph(Canvas* canvas, char c) {
+    size_t index = (size_t)(c - ' ') % 96;
+    size_t start = index >= 'a' - ' ' ? 'a' - ' ' : (index >= 'A' - ' ' ? 'A' - ' ' : 0);
+    const uint8_t* glyph = &canvas->font[start * (GLYPH_H + 1)];
+    for(size_t i = start; i < index; i++) {
+        glyph += glyph[0];
+    }
+    return glyph + 1;
+}
+
+static void stub_init_font(Canvas* canvas) {
+    uint32_t seed = 0x2545F491;
+    for(size_t i = 0; i < 96; i++) {
+        uint8_t* glyph = &canvas->font[i * (GLYPH_H + 1)];
+        glyph[0] = GLYPH_H + 1;
+        for(size_t row = 0; row < GLYPH_H; row++) {
+            seed = seed * 1103515245 + 12345;
+            glyph[row + 1] = i == 0 ? 0 : (seed >> 16) & 0x1f;
+        }
+    }
+}
+
+void canvas_clear(Canvas* canvas) {
+    canvas->calls++;
+    memset(canvas->fb, 0, sizeof(canvas->fb));
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    canvas->calls++;
+    canvas->current_font = font;
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    canvas->calls++;
+    for(; *str; str++, x += GLYPH_W + 1) {
+        const uint8_t* glyph = stub_glyph(canvas, *str);
+        canvas->glyphs++;
+        // Decoded as horizontal runs, one line call each
+        for(int32_t row = 0; row < GLYPH_H; row++) {
+            uint8_t bits = glyph[row];
+            for(int32_t col = 0; col < GLYPH_W;) {
+                if(!(bits & (1 << col))) {
+                    col++;
+                    continue;
+                }
+                int32_t run = col;
+                while(col < GLYPH_W && (bits & (1 << col))) col++;
+                stub_hline(canvas, x + run, y - GLYPH_H + 1 + row, col - run);
+            }
+        }
+    }
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    // Measuring the string looks every glyph up once more
+    int32_t width = 0;
+    for(const char* c = str; *c; c++) {
+        glyph_sink = stub_glyph(canvas, *c)[0];
+        width += GLYPH_W + 1;
+    }
+    if(horizontal == AlignCenter) x -= width / 2;
+    if(horizontal == AlignRight) x -= width;
+    if(vertical == AlignTop) y += GLYPH_H - 1;
+    if(vertical == AlignCenter) y += GLYPH_H / 2;
+    canvas_draw_str(canvas, x, y, str);
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    canvas->calls++;
+    (void)y2;
+    stub_hline(canvas, x1, y1, x2 - x1 + 1);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    canvas->calls++;
+    stub_hline(canvas, x, y, width);
+    stub_hline(canvas, x, y + height - 1, width);
+    for(size_t i = 1; i + 1 < height; i++) {
+        stub_pixel(canvas, x, y + i);
+        stub_pixel(canvas, x + width - 1, y + i);
+    }
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    canvas->calls++;
+    for(size_t i = 0; i < height; i++) {
+        stub_hline(canvas, x, y + i, width);
+    }
+}
+
+// The view before the model and string caches, kept as the baseline
+static void legacy_draw(Canvas* canvas, const BleashViewModel* model) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontSecondary);
+
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "BLE Leash");
+    canvas_draw_line(canvas, 0, 11, 128, 11);
+
+    const char* status_str = "Unknown";
+    switch(model->status) {
+    case 1:
+        status_str = "BT Off";
+        break;
+    case 2:
+        status_str = "Advertising";
+        break;
+    case 3:
+        status_str = "Connected";
+        break;
+    case 0:
+        status_str = "Unavailable";
+        break;
+    }
+
+    char observer_str[16];
+    if(model->observer) {
+        if(model->watchlist_empty) {
+            status_str = "No watch list";
+        } else {
+            snprintf(
+                observer_str,
+                sizeof(observer_str),
+                "Seen %u/%u",
+                model->present,
+                model->targets);
+            status_str = observer_str;
+        }
+    }
+
+    canvas_draw_str(canvas, 2, 24, status_str);
+
+    char profile_str[24];
+    snprintf(
+        profile_str,
+        sizeof(profile_str),
+        "%s %lu.%02lumAh/h",
+        model->profile_name,
+        (unsigned long)(model->cost_ua / 1000),
+        (unsigned long)((model->cost_ua % 1000) / 10));
+    canvas_draw_str_aligned(canvas, 126, 24, AlignRight, AlignBottom, profile_str);
+
+    if(model->show_signal) {
+        char rssi_str[32];
+        snprintf(rssi_str, sizeof(rssi_str), "Signal: %d dBm", model->rssi);
+        canvas_draw_str(canvas, 2, 36, rssi_str);
+
+        uint8_t bars = ((model->rssi + 130) / 10);
+        if(bars > 5) bars = 5;
+        canvas_draw_frame(canvas, 90, 29, 15, 8);
+        canvas_draw_box(canvas, 105, 31, 2, 4);
+        for(uint8_t i = 0; i < bars; i++) {
+            canvas_draw_box(canvas, 92 + (i * 3), 31, 2, 4);
+        }
+    }
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(
+        canvas,
+        64,
+        42,
+        AlignCenter,
+        AlignCenter,
+        model->running ? "Monitoring ON" : "Monitoring OFF");
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 2, 55, "OK: Toggle");
+    canvas_draw_str_aligned(canvas, 126, 55, AlignRight, AlignBottom, "Back: Hide");
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "Long Back: Exit");
+}
+
+// Connected session with the app's simulated RSSI walk, one sample per two frames
+static void session_model(BleashViewModel* model, uint32_t tick) {
+    static int8_t rssi = -50;
+    static uint8_t counter = 0;
+    if(tick % SESSION_TICKS_PER_SAMPLE == 0) {
+        counter++;
+        rssi += (counter % 20) - 10;
+        if(rssi > -30) rssi = -30;
+        if(rssi < -90) rssi = -90;
+    }
+
+    memset(model, 0, sizeof(BleashViewModel));
+    model->title = "BLE Leash";
+    model->profile_name = "Bal";
+    model->cost_ua = 1230;
+    model->status = 3;
+    model->rssi = rssi;
+    model->show_signal = true;
+    model->running = true;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static Canvas canvas;
+
+
+static double bench(bool cached) {
+    BleashViewCache cache;
+    BleashViewModel model;
+    double best = 0;
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+        bleash_view_cache_init(&cache);
+        double start = now_seconds();
+        for(uint32_t frame = 0; frame < BENCH_FRAMES; frame++) {
+            session_model(&model, frame);
+            // Like the GUI, which resets the canvas before calling the view port
+            memset(canvas.fb, 0, sizeof(canvas.fb));
+            if(cached) {
+                bleash_view_draw(&canvas, &cache, &model);
+            } else {
+                legacy_draw(&canvas, &model);
+            }
+        }
+        double elapsed = now_seconds() - start;
+        if(round == 0 || elapsed < best) best = elapsed;
+    }
+    return best * 1e9 / BENCH_FRAMES;
+}
+
+static void count_frame(bool cached, const char* label) {
+    BleashViewCache cache;
+    BleashViewModel model;
+    bleash_view_cache_init(&cache);
+    session_model(&model, 0);
+
+    canvas.calls = canvas.glyphs = canvas.pixel_ops = 0;
+    if(cached) {
+        bleash_view_draw(&canvas, &cache, &model);
+    } else {
+        legacy_draw(&canvas, &model);
+    }
+    printf(
+        "%-10s %3u calls, %3u glyphs, %5u pixel ops per frame\n",
+        label,
+        canvas.calls,
+        canvas.glyphs,
+        canvas.pixel_ops);
+}
+
+int main(void) {
+    stub_init_font(&canvas);
+
+    count_frame(false, "Legacy:");
+    count_frame(true, "Cached:");
+
+    double legacy_ns = bench(false);
+    double cached_ns = bench(true);
+    printf("Legacy:    %7.0f ns/frame\n", legacy_ns);
+    printf(
+        "Cached:    %7.0f ns/frame (%.0f%% less)\n",
+        cached_ns,
+        100 * (1 - cached_ns / legacy_ns));
+
+    // Ticks whose model matches the last drawn frame skip the redraw altogether
+    BleashViewModel model, drawn;
+    memset(&drawn, 0, sizeof(drawn));
+    uint32_t frames = 0;
+    for(uint32_t tick = 0; tick < SESSION_TICKS; tick++) {
+        session_model(&model, tick);
+        if(!bleash_view_model_equal(&model, &drawn)) {
+            drawn = model;
+            frames++;
+        }
+    }
+    printf("Session:   %u of %u ticks redrawn while connected\n", frames, SESSION_TICKS);
+    printf(
+        "Draw time per session hour: legacy %.1f ms, cached %.1f ms\n",
+        legacy_ns * SESSION_TICKS / 1e6,
+        cached_ns * frames / 1e6);
+    return 0;
+}